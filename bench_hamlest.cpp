@@ -0,0 +1,660 @@
+// Copyright 2013 by Martin Moene
+//
+// hamlest benchmarks. Run all benchmarks, or those whose name contains
+// any of the texts given on the command line (case insensitive).
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "hamlest.hpp"
+
+#include <iostream>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace lest::hamlest;
+
+// EXPECT_THAT as it expanded before actual and match were bound once:
+
+#define bench_EXPECT_THAT_TWICE( actual, match ) \
+    try \
+    { \
+        if ( ! match( actual ) ) \
+            throw lest::failure{ lest_LOCATION, \
+                lest::matching( #actual, #match ), \
+                lest::matching( lest::to_string(actual), match.to_string() ) }; \
+    } \
+    catch( lest::failure const & ) \
+    { \
+        throw ; \
+    } \
+    catch( std::exception const & e ) \
+    { \
+        throw lest::unexpected{ lest_LOCATION, lest::matching( #actual, #match ), lest::with_message( e.what() ) }; \
+    } \
+    catch(...) \
+    { \
+        throw lest::unexpected{ lest_LOCATION, lest::matching( #actual, #match ), "of unknown type" }; \
+    }
+
+// EXPECT as it expanded before the decomposition was described lazily:
+
+#define bench_EXPECT_EAGER( expr ) \
+    if ( lest::result score = lest_DECOMPOSE( expr ) ) \
+        throw lest::failure{ lest_LOCATION, #expr, score.decomposition };
+
+namespace {
+
+struct benchmark
+{
+    lest::text name;
+    std::function<void( std::ostream & )> run;
+};
+
+template< typename F >
+double seconds( int n, F f )
+{
+    lest::timer t;
+    for ( int i = 0; i < n; ++i )
+        f();
+    return t.elapsed_seconds();
+}
+
+void report( std::ostream & os, lest::text what, double secs )
+{
+    os << "  " << std::setw(40) << std::left << what << std::right
+       << std::fixed << std::setprecision(3) << std::setw(9) << 1000 * secs << " ms\n";
+}
+
+// emulate an expensive actual expression, e.g. decoding a multi-MB buffer:
+
+std::vector<int> const & buffer()
+{
+    static std::vector<int> buf( 1 << 22, 7 );
+    return buf;
+}
+
+long decode()
+{
+    return std::accumulate( buffer().begin(), buffer().end(), 0L );
+}
+
+int run_failing( std::function<void( lest::env & )> behaviour )
+{
+    lest::test fail[] = {{ "F", behaviour }};
+
+    std::ostringstream os;
+    return lest::run( fail, os );
+}
+
+int run_passing( std::function<void( lest::env & )> behaviour )
+{
+    lest::test pass[] = {{ "P", behaviour }};
+
+    std::ostringstream os;
+    return lest::run( pass, os );
+}
+
+// the failing EXPECT_THAT cases of example2.cpp, with either expansion:
+
+namespace example2 {
+
+int a() { return 33; }
+int b() { return 55; }
+int c() { return 77; }
+
+char const *hello() { return "hello"; }
+char const *world() { return "world"; }
+
+int x{11}, y{22};
+
+std::vector<int> p{ 1, 2, 3, 4, };
+std::vector<int> q{ 4, 3, 2, 1, };
+
+#define bench_EXAMPLE2_FAILURES( expect_that ) \
+{ \
+    CASE("equal_to vector<int> (fail)"      ) { expect_that( p, equal_to( q ) ); }, \
+    CASE("close_to int (fail)"              ) { expect_that( a() - 5, close_to( a(), 2 ) ); }, \
+    CASE("equal_to int (fail)"              ) { expect_that( a(), equal_to( b() ) ); }, \
+    CASE("not_equal_to int (fail)"          ) { expect_that( a(), not_equal_to( a() ) ); }, \
+    CASE("less_than int (fail)"             ) { expect_that( a(), less_than( a() ) ); }, \
+    CASE("less_equal int (fail)"            ) { expect_that( b(), less_equal( a() ) ); }, \
+    CASE("greater_than int (fail)"          ) { expect_that( a(), greater_than( a() ) ); }, \
+    CASE("greater_equal int (fail)"         ) { expect_that( a(), greater_equal( b() ) ); }, \
+    CASE("equal_to string (fail)"           ) { expect_that( hello(), equal_to( world() ) ); }, \
+    CASE("starts_with (fail)"               ) { expect_that( hello(), starts_with( "hex" ) ); }, \
+    CASE("ends_with (fail)"                 ) { expect_that( hello(), ends_with( "xo" ) ); }, \
+    CASE("contains (fail)"                  ) { expect_that( hello(), contains( world() ) ); }, \
+    CASE("contains_regexp (fail)"           ) { expect_that( hello(), contains_regexp( "x" ) ); }, \
+    CASE("matches_regexp (fail)"            ) { expect_that( hello(), matches_regexp( ".*x" ) ); }, \
+    CASE("anything int (fail)"              ) { expect_that( a(), is_not( anything<int>( "anything goes" ) ) ); }, \
+    CASE("same_instance (fail)"             ) { expect_that( x, same_instance( y ) ); }, \
+    CASE("is equal_to int (fail)"           ) { expect_that( a(), is( equal_to( b() ) ) ); }, \
+    CASE("is double (fail)"                 ) { expect_that( a(), is( 77.0) ); }, \
+    CASE("is string (fail)"                 ) { expect_that( hello(), is( world() ) ); }, \
+    CASE("is_not string (fail)"             ) { expect_that( hello(), is_not( hello() ) ); }, \
+    CASE("all_of int (fail)"                ) { expect_that( a(), all_of( equal_to(a()), equal_to(b()) ) ); }, \
+    CASE("all_of contains (fail)"           ) { expect_that( hello(), all_of( starts_with("hel"), ends_with("lo"), contains("xx") ) ); }, \
+    CASE("any_of int (fail)"                ) { expect_that( a(), any_of( equal_to(b()), equal_to(c()) ) ); }, \
+    CASE("any_of int sequence (fail)"       ) { expect_that( a(), any_of( { b(), b() } ) ); }, \
+}
+
+const lest::test failures_twice[] = bench_EXAMPLE2_FAILURES( bench_EXPECT_THAT_TWICE );
+const lest::test failures_once[]  = bench_EXAMPLE2_FAILURES( EXPECT_THAT );
+
+} // namespace example2
+
+std::vector<std::string> const & log_lines()
+{
+    static std::vector<std::string> lines( 10000, "2013-09-30 12:00:00 INFO service started on port 8080" );
+    return lines;
+}
+
+std::string const & service_output()
+{
+    static std::string text;
+
+    if ( text.empty() )
+    {
+        while ( text.size() < ( 1u << 20 ) )
+            text += "2013-09-30 12:00:00 INFO request " + std::to_string( text.size() ) + " handled in 12 ms\n";
+    }
+    return text;
+}
+
+void report_throughput( std::ostream & os, lest::text what, std::size_t bytes, double secs )
+{
+    os << "  " << std::setw(40) << std::left << what << std::right
+       << std::fixed << std::setprecision(1) << std::setw(9) << bytes / secs / 1e6 << " MB/s\n";
+}
+
+// fused all_of( matcher... ) versus the same matchers evaluated one by one:
+
+template< typename M >
+void report_fused( std::ostream & os, std::string const & actual, M const & fused, std::vector<any_matcher<std::string>> const & separate )
+{
+    int count = 0;
+
+    os << " " << separate.size() << " matchers:\n";
+
+    report_throughput( os, "all_of( std::vector<any_matcher> )", actual.size(), seconds( 1, [&]{ count += all_of( separate )( actual ); } ) );
+    report_throughput( os, "all_of( matcher... ), fused", actual.size(), seconds( 1, [&]{ count += fused( actual ); } ) );
+
+    os << "  (" << count << " matches)\n";
+}
+
+const benchmark benchmarks[] =
+{
+    { "expect_that: failing run of example2.cpp", []( std::ostream & os )
+    {
+        const int n = 1000;
+
+        report( os, "actual and match evaluated twice", seconds( n, []{
+            std::ostringstream out; lest::run( example2::failures_twice, out ); } ) );
+
+        report( os, "actual and match evaluated once", seconds( n, []{
+            std::ostringstream out; lest::run( example2::failures_once, out ); } ) );
+    }},
+
+    { "expect_that: failing run, expensive actual", []( std::ostream & os )
+    {
+        const int n = 50;
+
+        report( os, "actual and match evaluated twice", seconds( n, []{
+            run_failing( []( lest::env & ) { bench_EXPECT_THAT_TWICE( decode(), equal_to( 0L ) ) } ); } ) );
+
+        report( os, "actual and match evaluated once", seconds( n, []{
+            run_failing( []( lest::env & ) { EXPECT_THAT( decode(), equal_to( 0L ) ); } ); } ) );
+    }},
+
+    { "equal_to: failing run, 10^6-element vectors differing at one index", []( std::ostream & os )
+    {
+        static std::vector<int> expected( 1000000 );
+        std::iota( expected.begin(), expected.end(), 0 );
+
+        static std::vector<int> actual( expected );
+        actual[ actual.size() / 2 ] = -1;
+
+        std::size_t size = 0;
+
+        report( os, "lest::to_string() of actual and expected", seconds( 1, [&]{
+            size += lest::to_string( actual ).size() + lest::to_string( expected ).size(); } ) );
+
+        report( os, "EXPECT_THAT( actual, equal_to(...) )", seconds( 1, []{
+            run_failing( []( lest::env & ) { EXPECT_THAT( actual, equal_to( expected ) ); } ); } ) );
+
+        os << "  (" << size << " characters)\n";
+    }},
+
+    { "lest::to_string: 10^6-element vector, default limit versus all elements", []( std::ostream & os )
+    {
+        const std::vector<int> v( 1000000, 42 );
+        const std::vector<std::vector<int>> nested( 1000, std::vector<int>( 1000, 42 ) );
+
+        std::size_t size = 0;
+
+        report( os, "to_string(), default limit", seconds( 1, [&]{ size += lest::to_string( v ).size(); } ) );
+        report( os, "to_string(), nested, default limit", seconds( 1, [&]{ size += lest::to_string( nested ).size(); } ) );
+
+        const auto saved = lest::to_string_limits();
+        lest::to_string_limits().max_elements = 0;
+
+        report( os, "to_string(), all elements", seconds( 1, [&]{ size += lest::to_string( v ).size(); } ) );
+        report( os, "to_string(), nested, all elements", seconds( 1, [&]{ size += lest::to_string( nested ).size(); } ) );
+
+        lest::to_string_limits() = saved;
+
+        os << "  (" << size << " characters)\n";
+    }},
+
+    { "expect: passing EXPECTs, 10^7 ints and 10^6 small vectors", []( std::ostream & os )
+    {
+        report( os, "EXPECT( i >= 0 ), eagerly described", seconds( 1, []{
+            run_passing( []( lest::env & ) { for ( int i = 0; i < 10000000; ++i ) { bench_EXPECT_EAGER( i >= 0 ) } } ); } ) );
+
+        report( os, "EXPECT( i >= 0 )", seconds( 1, []{
+            run_passing( []( lest::env & lest_env ) { for ( int i = 0; i < 10000000; ++i ) { EXPECT( i >= 0 ); } } ); } ) );
+
+        report( os, "EXPECT( v == w ), eagerly described", seconds( 1, []{
+            run_passing( []( lest::env & ) { std::vector<int> v{ 1, 2, 3, 4 }, w( v );
+                for ( int i = 0; i < 1000000; ++i ) { bench_EXPECT_EAGER( v == w ) } } ); } ) );
+
+        report( os, "EXPECT( v == w )", seconds( 1, []{
+            run_passing( []( lest::env & lest_env ) { std::vector<int> v{ 1, 2, 3, 4 }, w( v );
+                for ( int i = 0; i < 1000000; ++i ) { EXPECT( v == w ); } } ); } ) );
+    }},
+
+    { "lest::to_string: 10^6 ints, doubles and log lines", []( std::ostream & os )
+    {
+        const int n = 1000000;
+        std::size_t size = 0;
+
+        report( os, "std::ostringstream, ints", seconds( 1, [&]{
+            for ( int i = 0; i < n; ++i ) { std::ostringstream oss; oss << i; size += oss.str().size(); } } ) );
+        report( os, "to_string(), ints", seconds( 1, [&]{
+            for ( int i = 0; i < n; ++i ) size += lest::to_string( i ).size(); } ) );
+
+        report( os, "std::ostringstream, doubles", seconds( 1, [&]{
+            for ( int i = 0; i < n; ++i ) { std::ostringstream oss; oss << i * 0.001; size += oss.str().size(); } } ) );
+        report( os, "to_string(), doubles", seconds( 1, [&]{
+            for ( int i = 0; i < n; ++i ) size += lest::to_string( i * 0.001 ).size(); } ) );
+
+        const std::string line = log_lines().front() + "\r\n";
+
+        report( os, "to_string(), log lines", seconds( 1, [&]{
+            for ( int i = 0; i < n; ++i ) size += lest::to_string( line ).size(); } ) );
+
+        os << "  (" << size << " characters)\n";
+    }},
+
+    { "run: 64 CPU-bound tests, --jobs=1 versus --jobs and --fork-jobs", []( std::ostream & os )
+    {
+        std::vector<lest::test> spec( 64, lest::test{ "CPU-bound", []( lest::env & lest_env )
+        {
+            std::vector<int> v( 200000 );
+            std::mt19937 random( 42 );
+            for ( auto & x : v ) x = static_cast<int>( random() );
+            std::sort( v.begin(), v.end() );
+            EXPECT( std::is_sorted( v.begin(), v.end() ) );
+        }});
+
+        std::ostringstream out;
+
+        report( os, "--jobs=1", seconds( 1, [&]{ lest::run( spec, { "--jobs=1" }, out ); } ) );
+        report( os, "--jobs (" + std::to_string( std::thread::hardware_concurrency() ) + " threads)", seconds( 1, [&]{ lest::run( spec, { "--jobs" }, out ); } ) );
+#if lest_FEATURE_FORK
+        report( os, "--fork-jobs (" + std::to_string( std::thread::hardware_concurrency() ) + " processes)", seconds( 1, [&]{ lest::run( spec, { "--fork-jobs" }, out ); } ) );
+#endif
+    }},
+
+    { "all_of: value-composed versus type-erased Matcher<T>, 10^7 ints", []( std::ostream & os )
+    {
+        const int n = 10000000;
+        auto match = all_of( greater_than( -1 ), less_than( n ), is_not( equal_to( n / 2 ) ) );
+        lest::Matcher<int> erased = match.copy();
+
+        int count = 0;
+
+        report( os, "value-composed all_of()", seconds( 1, [&]{
+            for ( int i = 0; i < n; ++i ) count += match( i ); } ) );
+
+        report( os, "type-erased Matcher<int>", seconds( 1, [&]{
+            for ( int i = 0; i < n; ++i ) count += (*erased)( i ); } ) );
+
+        os << "  (" << count << " matches)\n";
+    }},
+
+    { "any_of: runtime-built any_matcher<T> versus Matcher<T> list, 10^7 ints", []( std::ostream & os )
+    {
+        const int n = 10000000;
+
+        std::vector<lest::Matcher<int>> shared{ equal_to( -1 ).copy(), equal_to( -2 ).copy(), less_than( -3 ).copy(), greater_than( n ).copy() };
+        std::vector<any_matcher<int>>   local { equal_to( -1 ), equal_to( -2 ), less_than( -3 ), greater_than( n ) };
+
+        auto match = any_of( local );
+        int count = 0;
+
+        report( os, "Matcher<int> taken by value", seconds( 1, [&]{
+            for ( int i = 0; i < n; ++i )
+                count += std::any_of( shared.begin(), shared.end(), [i]( lest::Matcher<int> m ) { return (*m)( i ); } ); } ) );
+
+        report( os, "any_of( std::vector<any_matcher<int>> )", seconds( 1, [&]{
+            for ( int i = 0; i < n; ++i ) count += match( i ); } ) );
+
+        os << "  (" << count << " matches)\n";
+    }},
+
+    { "starts_with, ends_with: prefix and suffix of 100 MB actual", []( std::ostream & os )
+    {
+        const std::string actual( 100000000, 'x' );
+        const std::string text( "hello" );
+        int count = 0;
+
+        report( os, "std::string::find() as prefix", seconds( 1, [&]{ count += 0 == actual.find( text ); } ) );
+        report( os, "starts_with()", seconds( 1, [&]{ count += starts_with( text )( actual ); } ) );
+        report( os, "starts_with(), char const *", seconds( 1, [&]{ count += starts_with( text )( actual.c_str() ); } ) );
+
+        report( os, "std::string::find() as suffix", seconds( 1, [&]{ count += actual.find( text ) == actual.size() - text.size(); } ) );
+        report( os, "ends_with()", seconds( 1, [&]{ count += ends_with( text )( actual ); } ) );
+
+        os << "  (" << count << " matches)\n";
+    }},
+
+    { "contains: substring search in 64 MB actual", []( std::ostream & os )
+    {
+        std::string actual( 64 << 20, 'x' );
+        for ( std::size_t i = 0; i < actual.size(); i += 61 )
+            actual[i] = 'n';
+
+        const std::string text( "needle" );
+        std::size_t count = 0;
+
+        report_throughput( os, "std::string::find()", actual.size(), seconds( 1, [&]{ count += actual.find( text ); } ) );
+        report_throughput( os, "std::search()", actual.size(), seconds( 1, [&]{
+            count += static_cast<std::size_t>( std::search( actual.begin(), actual.end(), text.begin(), text.end() ) - actual.begin() ); } ) );
+        report_throughput( os, "contains()", actual.size(), seconds( 1, [&]{ count += contains( text )( actual ); } ) );
+        report_throughput( os, "lest::find_text(), case insensitive", actual.size(), seconds( 1, [&]{
+            count += lest::find_text( actual.data(), actual.size(), text.data(), text.size(), true ); } ) );
+
+        os << "  (" << count << ")\n";
+    }},
+
+    { "contains_any_of, contains_all_of: N patterns at the end of 1 MB service output", []( std::ostream & os )
+    {
+        for ( std::size_t n : { 4, 16, 64, 256 } )
+        {
+            std::vector<std::string> patterns;
+            for ( std::size_t i = 0; i < n; ++i )
+                patterns.push_back( std::string( "#" ) + char( 'a' + i % 26 ) + char( 'a' + i / 26 % 26 ) + "!" );
+
+            const std::string last  = service_output() + patterns.back();
+            const std::string every = service_output() + std::accumulate( patterns.begin(), patterns.end(), std::string() );
+
+            auto any = contains_any_of( patterns );
+            auto all = contains_all_of( patterns );
+            int count = 0;
+
+            os << " " << n << " patterns:\n";
+
+            report( os, "contains() per pattern, any", seconds( 1, [&]{ count += std::any_of( patterns.begin(), patterns.end(),
+                [&]( std::string const & p ) { return contains( p )( last ); } ); } ) );
+            report( os, "contains_any_of()", seconds( 1, [&]{ count += any( last ); } ) );
+
+            report( os, "contains() per pattern, all", seconds( 1, [&]{ count += std::all_of( patterns.begin(), patterns.end(),
+                [&]( std::string const & p ) { return contains( p )( every ); } ); } ) );
+            report( os, "contains_all_of()", seconds( 1, [&]{ count += all( every ); } ) );
+
+            os << "  (" << count << " matches)\n";
+        }
+    }},
+
+    { "all_of: fused textual matchers on 64 MB service output, texts at the end", []( std::ostream & os )
+    {
+        std::vector<std::string> p;
+        for ( int i = 0; i < 20; ++i )
+            p.push_back( std::string( "#" ) + char( 'a' + i ) + "!" );
+
+        std::string actual = p[0];
+        while ( actual.size() < ( 64u << 20 ) )
+            actual += service_output();
+        for ( auto & text : p )
+            actual += text;
+
+        auto s = []( std::string const & t ) { return starts_with( t ); };
+        auto c = []( std::string const & t ) { return contains( t ); };
+        auto e = []( std::string const & t ) { return ends_with( t ); };
+
+        report_fused( os, actual, all_of( s(p[0]), c(p[1]), e(p[19]) ), { s(p[0]), c(p[1]), e(p[19]) } );
+
+        report_fused( os, actual,
+            all_of( s(p[0]), c(p[1]), c(p[2]), c(p[3]), c(p[4]), c(p[5]), c(p[6]), c(p[7]), c(p[8]), e(p[19]) ),
+                  { s(p[0]), c(p[1]), c(p[2]), c(p[3]), c(p[4]), c(p[5]), c(p[6]), c(p[7]), c(p[8]), e(p[19]) } );
+
+        report_fused( os, actual,
+            all_of( s(p[0]), c(p[1]), c(p[2]), c(p[3]), c(p[4]), c(p[5]), c(p[6]), c(p[7]), c(p[8]), c(p[9]),
+                    c(p[10]), c(p[11]), c(p[12]), c(p[13]), c(p[14]), c(p[15]), c(p[16]), c(p[17]), c(p[18]), e(p[19]) ),
+                  { s(p[0]), c(p[1]), c(p[2]), c(p[3]), c(p[4]), c(p[5]), c(p[6]), c(p[7]), c(p[8]), c(p[9]),
+                    c(p[10]), c(p[11]), c(p[12]), c(p[13]), c(p[14]), c(p[15]), c(p[16]), c(p[17]), c(p[18]), e(p[19]) } );
+    }},
+
+    { "contains: element in 10^6-element set, unordered_set and sorted vector", []( std::ostream & os )
+    {
+        std::vector<int> v( 1000000 );
+        for ( std::size_t i = 0; i < v.size(); ++i )
+            v[i] = static_cast<int>( 2 * i );
+
+        const std::set<int> set( v.begin(), v.end() );
+        const std::unordered_set<int> hashed( v.begin(), v.end() );
+        const int n = 10;
+        int count = 0;
+
+        report( os, "std::find() in std::set, 10 x", seconds( n, [&]{ count += set.end() != std::find( set.begin(), set.end(), 1999998 ); } ) );
+        report( os, "contains() in std::set, 10 x", seconds( n, [&]{ count += contains( 1999998 )( set ); } ) );
+        report( os, "contains() in std::unordered_set, 10 x", seconds( n, [&]{ count += contains( 1999998 )( hashed ); } ) );
+        report( os, "contains() in std::vector, 10 x", seconds( n, [&]{ count += contains( 1999998 )( v ); } ) );
+        report( os, "contains() in sorted( std::vector ), 10 x", seconds( n, [&]{ count += contains( 1999998 )( sorted( v ) ); } ) );
+
+        os << "  (" << count << " matches)\n";
+    }},
+
+    { "contains: 1k-element packet pattern at the end of 16 MB sample buffers", []( std::ostream & os )
+    {
+        std::mt19937 random( 42 );
+
+        std::vector<std::uint8_t> bytes( 16 << 20 );
+        for ( auto & x : bytes )
+            x = static_cast<std::uint8_t>( random() );
+
+        std::vector<std::int16_t> samples( 8 << 20 );
+        for ( auto & x : samples )
+            x = static_cast<std::int16_t>( random() % 2000 );
+
+        std::vector<int> words( 4 << 20 );
+        for ( auto & x : words )
+            x = static_cast<int>( random() % 2000 );
+
+        const std::vector<std::uint8_t> byte_packet( bytes.end() - 1000, bytes.end() );
+        const std::vector<std::int16_t> sample_packet( samples.end() - 1000, samples.end() );
+        const std::vector<int> word_packet( words.end() - 1000, words.end() );
+        int count = 0;
+
+        report_throughput( os, "std::search(), uint8_t", bytes.size(), seconds( 1, [&]{
+            count += bytes.end() != std::search( bytes.begin(), bytes.end(), byte_packet.begin(), byte_packet.end() ); } ) );
+        report_throughput( os, "contains(), uint8_t", bytes.size(), seconds( 1, [&]{ count += contains( byte_packet )( bytes ); } ) );
+
+        report_throughput( os, "std::search(), int16_t", 2 * samples.size(), seconds( 1, [&]{
+            count += samples.end() != std::search( samples.begin(), samples.end(), sample_packet.begin(), sample_packet.end() ); } ) );
+        report_throughput( os, "contains(), int16_t", 2 * samples.size(), seconds( 1, [&]{ count += contains( sample_packet )( samples ); } ) );
+
+        report_throughput( os, "std::search(), int", 4 * words.size(), seconds( 1, [&]{
+            count += words.end() != std::search( words.begin(), words.end(), word_packet.begin(), word_packet.end() ); } ) );
+        report_throughput( os, "contains(), int", 4 * words.size(), seconds( 1, [&]{ count += contains( word_packet )( words ); } ) );
+
+        os << "  (" << count << " matches)\n";
+    }},
+
+    { "has_key, has_entries: 10^6-key index", []( std::ostream & os )
+    {
+        std::map<int, int> index;
+        std::unordered_map<int, int> hashed;
+        for ( int i = 0; i < 1000000; ++i )
+        {
+            index.emplace_hint( index.end(), 2 * i, i ); hashed.emplace( 2 * i, i );
+        }
+
+        std::vector<std::pair<int, int>> linear( index.begin(), index.end() );
+
+        std::map<int, int> expected;
+        for ( int i = 0; i < 1000000; i += 4 )
+            expected.emplace_hint( expected.end(), 2 * i, i );
+
+        int count = 0;
+
+        report( os, "has_key(), std::vector of std::pair", seconds( 1, [&]{ count += has_key( 1999998 )( linear ); } ) );
+        report( os, "has_key(), std::map", seconds( 1, [&]{ count += has_key( 1999998 )( index ); } ) );
+
+        report( os, "std::map::find() per expected entry", seconds( 1, [&]{ count += std::all_of( expected.begin(), expected.end(),
+            [&]( std::pair<const int, int> const & e ) { auto pos = index.find( e.first ); return pos != index.end() && pos->second == e.second; } ); } ) );
+        report( os, "has_entries(), std::map", seconds( 1, [&]{ count += has_entries( expected )( index ); } ) );
+        report( os, "has_entries(), std::unordered_map", seconds( 1, [&]{ count += has_entries( expected )( hashed ); } ) );
+
+        os << "  (" << count << " matches)\n";
+    }},
+
+    { "contains_elements: 10^4 expected ids in 10^5-element result set", []( std::ostream & os )
+    {
+        std::vector<int> ids( 100000 );
+        for ( std::size_t i = 0; i < ids.size(); ++i )
+            ids[i] = static_cast<int>( 3 * i );
+
+        std::vector<int> expected;
+        for ( int i = 0; i < 10000; ++i )
+            expected.push_back( 30 * i );
+
+        std::vector<std::pair<int,int>> pairs, expected_pairs;
+        for ( int id : ids )
+            pairs.push_back( std::make_pair( id, 0 ) );
+        for ( int id : expected )
+            expected_pairs.push_back( std::make_pair( id, 0 ) );
+
+        const std::set<int> id_set( ids.begin(), ids.end() );
+        int count = 0;
+
+        report( os, "std::count per element", seconds( 1, [&]{ count += std::all_of( expected.begin(), expected.end(),
+            [&]( int id ) { return 0 != std::count( ids.begin(), ids.end(), id ); } ); } ) );
+        report( os, "contains_elements(), hashed", seconds( 1, [&]{ count += contains_elements( expected )( ids ); } ) );
+        report( os, "contains_elements(), sorted", seconds( 1, [&]{ count += contains_elements( expected_pairs )( pairs ); } ) );
+        report( os, "contains_elements(), std::set::find()", seconds( 1, [&]{ count += contains_elements( expected )( id_set ); } ) );
+
+        os << "  (" << count << " matches)\n";
+    }},
+
+    { "is_permutation_of: shuffled ids, 10^4 and 10^6 elements", []( std::ostream & os )
+    {
+        std::mt19937 random( 42 );
+
+        std::vector<int> small( 10000 ), large( 1000000 );
+        std::iota( small.begin(), small.end(), 0 );
+        std::iota( large.begin(), large.end(), 0 );
+
+        std::vector<int> small_shuffled( small ), large_shuffled( large );
+        std::shuffle( small_shuffled.begin(), small_shuffled.end(), random );
+        std::shuffle( large_shuffled.begin(), large_shuffled.end(), random );
+
+        std::vector<std::string> names;
+        for ( int i = 0; i < 100000; ++i )
+            names.push_back( "user-" + std::to_string( i ) );
+        std::vector<std::string> names_shuffled( names );
+        std::shuffle( names_shuffled.begin(), names_shuffled.end(), random );
+
+        int count = 0;
+
+        report( os, "std::is_permutation(), 10^4 ints", seconds( 1, [&]{
+            count += std::is_permutation( small_shuffled.begin(), small_shuffled.end(), small.begin() ); } ) );
+        report( os, "is_permutation_of(), 10^4 ints", seconds( 1, [&]{ count += is_permutation_of( small )( small_shuffled ); } ) );
+        report( os, "is_permutation_of(), 10^6 ints", seconds( 1, [&]{ count += is_permutation_of( large )( large_shuffled ); } ) );
+        report( os, "is_permutation_of(), 10^5 strings", seconds( 1, [&]{ count += is_permutation_of( names )( names_shuffled ); } ) );
+
+        os << "  (" << count << " matches)\n";
+    }},
+
+    { "is_sorted, has_unique_elements: output of sort and dedup stage, 10^7 ints", []( std::ostream & os )
+    {
+        std::vector<int> v( 10000000 );
+        std::iota( v.begin(), v.end(), 0 );
+
+        int count = 0;
+
+        report( os, "std::is_sorted()", seconds( 1, [&]{ count += std::is_sorted( v.begin(), v.end() ); } ) );
+        report( os, "is_sorted()", seconds( 1, [&]{ count += is_sorted()( v ); } ) );
+        report( os, "is_strictly_increasing()", seconds( 1, [&]{ count += is_strictly_increasing()( v ); } ) );
+        report( os, "has_unique_elements()", seconds( 1, [&]{ count += has_unique_elements()( v ); } ) );
+        report( os, "is_sorted() fails at index 10", seconds( 1, [&]{ v[10] = -1; count += is_sorted()( v ); v[10] = 10; } ) );
+
+        os << "  (" << count << " matches)\n";
+    }},
+
+    { "matches_regexp: matcher in loop over log lines", []( std::ostream & os )
+    {
+        const char * pattern = "[0-9-]+ [0-9:]+ INFO .*port [0-9]+";
+
+        report( os, "std::regex compiled per line", seconds( 1, [=]{
+            for ( auto & line : log_lines() ) std::regex_match( line, std::regex( pattern ) ); } ) );
+
+        report( os, "matches_regexp() per line", seconds( 1, [=]{
+            for ( auto & line : log_lines() ) matches_regexp( pattern )( line ); } ) );
+
+        auto match = matches_regexp( pattern );
+
+        report( os, "matches_regexp() once", seconds( 1, [&]{
+            for ( auto & line : log_lines() ) match( line ); } ) );
+    }},
+
+    { "contains_regexp: throughput of engines on 1 MB service output", []( std::ostream & os )
+    {
+        for ( auto pattern : { "ERROR [0-9]+", "request [0-9]+ handled in [0-9]{4,} ms", "(?:FATAL|PANIC|ERROR).*timeout" } )
+        {
+            os << " " << lest::to_string( pattern ) << ":\n";
+
+            for ( auto engine : { regex_engine::standard, regex_engine::linear } )
+            {
+                auto match = contains_regexp( pattern, engine );
+
+                report_throughput( os, engine == regex_engine::linear ? "linear_regex" : "std::regex",
+                    service_output().size(), seconds( 1, [&]{ match( service_output() ); } ) );
+            }
+        }
+    }},
+
+    { "matches_regexp: pathological expression (a*)*b", []( std::ostream & os )
+    {
+        for ( auto engine : { regex_engine::standard, regex_engine::linear } )
+        {
+            auto match = matches_regexp( "(a*)*b", engine );
+            const std::string text( 14, 'a' );
+
+            report( os, engine == regex_engine::linear ? "linear_regex, 14 x 'a'" : "std::regex, 14 x 'a'",
+                seconds( 1, [&]{ match( text ); } ) );
+        }
+    }},
+};
+
+} // anonymous namespace
+
+int main( int argc, char * argv[] )
+{
+    lest::texts in( argv + 1, argv + argc );
+
+    for ( auto & bench : benchmarks )
+    {
+        if ( in.empty() || lest::match( in, bench.name ) )
+        {
+            std::cout << bench.name << ":\n";
+            bench.run( std::cout );
+        }
+    }
+}
+
+// g++ -Wall -Wextra -Weffc++ -O2 -std=c++11 -o bench_hamlest.exe bench_hamlest.cpp && bench_hamlest.exe
@@ -12,10 +12,23 @@
 
 #include "lest.hpp"
 
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <regex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#ifndef  lest_FEATURE_REGEX_CACHE_SIZE
+# define lest_FEATURE_REGEX_CACHE_SIZE  64
+#endif
+
 #ifndef lest_NO_SHORT_ASSERTION_NAMES
 # define EXPECT_THAT  lest_EXPECT_THAT
 #endif
@@ -23,10 +36,7 @@
 #define lest_EXPECT_THAT( actual, match ) \
     try \
     { \
-        if ( ! match( actual ) ) \
-            throw lest::failure{ lest_LOCATION, \
-                lest::matching( #actual, #match ), \
-                lest::matching( lest::to_string(actual), match.to_string() ) }; \
+        lest::expect_that( lest_LOCATION, lest::matching( #actual, #match ), actual, match ); \
     } \
     catch( lest::failure const & ) \
     { \
@@ -48,6 +58,171 @@ inline std::string matching( std::string actual, std::string match )
     return actual + " " + match;
 }
 
+template <typename C>
+using iterator_of = decltype( std::begin( std::declval<C const &>() ) );
+
+template <typename C>
+using element_of = typename std::iterator_traits< iterator_of<C> >::value_type;
+
+/**
+ * is_sequence: container that is described element by element, i.e. other
+ * than text.
+ */
+template <typename T, typename = void>
+struct is_sequence : std::false_type { };
+
+template <typename T>
+struct is_sequence< T, typename std::enable_if< is_container<T>::value >::type > : std::integral_constant< bool,
+    ! std::is_same< element_of<T>, char >::value && ! std::is_same< element_of<T>, wchar_t >::value > { };
+
+template <typename T, typename R>
+using ForSequence = typename std::enable_if< is_sequence<T>::value, R >::type;
+
+template <typename T, typename R>
+using ForNonSequence = typename std::enable_if< ! is_sequence<T>::value, R >::type;
+
+/**
+ * compact_string( cont, limit ): the first limit elements of a container,
+ * followed by the number of elements left out.
+ */
+template <typename C>
+inline std::string compact_string( C const & cont, std::size_t limit )
+{
+    std::ostringstream os;
+    write_container( os, cont, limit );
+    return os.str();
+}
+
+/**
+ * bounded_string( value ): value as text, with at most the elements of a
+ * container that lest::to_string shows, see option --max-elements.
+ */
+template <typename T>
+inline auto bounded_string( T const & value ) -> ForNonSequence<T, std::string>
+{
+    return lest::to_string( value );
+}
+
+template <typename C>
+inline auto bounded_string( C const & cont ) -> ForSequence<C, std::string>
+{
+    return compact_string( cont, lest::to_string_limits().max_elements );
+}
+
+/**
+ * window_string( cont, index, radius ): the element at index of a container
+ * with up to radius elements on either side, each with its index.
+ */
+template <typename C>
+inline std::string window_string( C const & cont, std::size_t index, std::size_t radius )
+{
+    const std::size_t first = index > radius ? index - radius : 0;
+
+    std::ostringstream os;
+    os << "{ " << ( first > 0 ? "..., " : "" );
+
+    auto pos = std::next( std::begin( cont ), static_cast<std::ptrdiff_t>( first ) );
+    for ( std::size_t i = first; pos != std::end( cont ) && i <= index + radius; ++pos, ++i )
+        os << "[" << i << "] " << lest::to_string( *pos ) << ", ";
+
+    os << ( pos != std::end( cont ) ? "... }" : "}" );
+    return os.str();
+}
+
+/**
+ * describe_differences( actual, expected ): the size difference and the
+ * first few differing indices of two sequences, each with the actual
+ * elements around it unless that window would show all of actual, which
+ * the failure message already does; capped at max_description characters.
+ */
+template <typename C, typename E>
+inline std::string describe_differences( C const & actual, E const & expected )
+{
+    enum { max_differences = 5, radius = 2, max_description = 2000 };
+
+    const std::size_t actual_size   = static_cast<std::size_t>( std::distance( std::begin( actual   ), std::end( actual   ) ) );
+    const std::size_t expected_size = static_cast<std::size_t>( std::distance( std::begin( expected ), std::end( expected ) ) );
+    const std::size_t common_size   = (std::min)( actual_size, expected_size );
+
+    std::ostringstream os;
+    std::string sep;
+
+    if ( actual_size != expected_size )
+    {
+        os << "size " << actual_size << " instead of " << expected_size;
+        sep = "; ";
+    }
+
+    const auto actual_end = std::next( std::begin( actual ), static_cast<std::ptrdiff_t>( common_size ) );
+    const bool show_window = actual_size > 2 * radius + 1;
+
+    auto a = std::begin( actual );
+    auto e = std::begin( expected );
+    std::size_t index = 0, shown = 0, more = 0;
+
+    for ( ;; ++a, ++e, ++index )
+    {
+        const auto next = std::mismatch( a, actual_end, e );
+
+        if ( next.first == actual_end )
+            break;
+
+        index += static_cast<std::size_t>( std::distance( a, next.first ) );
+        a = next.first;
+        e = next.second;
+
+        if ( shown++ < max_differences )
+        {
+            os << sep << "at index " << index << " " << lest::to_string( *a ) << " instead of " << lest::to_string( *e );
+
+            if ( show_window )
+                os << " in " << window_string( actual, index, radius );
+
+            sep = "; ";
+        }
+        else
+        {
+            ++more;
+        }
+    }
+
+    if ( more > 0 )
+        os << sep << more << " more differing elements";
+
+    const std::string result = os.str();
+
+    return result.size() <= max_description ? result : result.substr( 0, max_description ) + "...";
+}
+
+/**
+ * matcher description, followed by the matcher's explanation of the mismatch
+ * with the actual value, if the matcher provides describe_mismatch( actual ).
+ */
+template <typename M, typename T>
+inline auto describe( M const & match, T const & actual, int ) -> decltype( std::string( match.describe_mismatch( actual ) ) )
+{
+    const std::string mismatch = match.describe_mismatch( actual );
+    return mismatch.empty() ? match.to_string() : match.to_string() + ": " + mismatch;
+}
+
+template <typename M, typename T>
+inline std::string describe( M const & match, T const &, long )
+{
+    return match.to_string();
+}
+
+/**
+ * match actual value, that is evaluated only once, and report failure.
+ * Note: actual and match are bound by the caller, hence neither the actual
+ * expression nor the matcher expression is re-evaluated to describe a failure.
+ */
+template <typename T, typename M>
+inline void expect_that( location where, std::string expr, T const & actual, M const & match )
+{
+    if ( ! match( actual ) )
+        throw failure{ where, expr, matching( bounded_string( actual ), describe( match, actual, 0 ) ) };
+}
+
 template <typename T>
 struct matcher;
 
@@ -86,21 +261,185 @@ struct matcher_tag { };
 /**
  * matcher traits for argument type and matcher-value distinction.
  */
-template <typename T>
+template <typename T, typename = void>
 struct matcher_traits
 {
     using argument = T;
     using category = not_matcher_tag;
 };
 
-#define LEST_TAG_MATCHER(matcher_type)          \
-    template <typename T>                       \
-    struct matcher_traits< matcher_type<T> >    \
-    {                                           \
-        using argument = T;                     \
-        using category = matcher_tag;           \
+template <typename T>
+struct matcher_traits< T, typename std::enable_if< std::is_base_of< matcher<typename T::argument_type>, T >::value >::type >
+{
+    using argument = typename T::argument_type;
+    using category = matcher_tag;
+};
+
+/**
+ * evaluate matcher of known type inline, without virtual dispatch;
+ * yields false if the matcher does not accept the actual value, like matcher<T>.
+ */
+template <typename M, typename A>
+inline auto evaluate( M const & match, A const & actual, int ) -> decltype( bool( match.M::operator()( actual ) ) )
+{
+    return match.M::operator()( actual );
+}
+
+template <typename M, typename A>
+inline bool evaluate( M const &, A const &, long )
+{
+    return false;
+}
+
+template <typename M, typename A>
+inline bool evaluate( M const & match, A const & actual )
+{
+    return evaluate( match, actual, 0 );
+}
+
+/**
+ * any_matcher<T>: type-erased matcher with value semantics. Matchers that fit
+ * the small buffer are stored in place, larger ones on the heap; copies clone
+ * the matcher, there is no (atomic) reference counting. A moved-from
+ * any_matcher matches nothing and describes itself as "".
+ */
+template <typename T>
+class any_matcher : public matcher<T>
+{
+public:
+    static const std::size_t buffer_size = 64;
+
+    template <typename M, typename = typename std::enable_if<
+        std::is_same< typename matcher_traits<M>::category, matcher_tag >::value &&
+        ! std::is_abstract<M>::value && ! std::is_same<M, any_matcher>::value >::type >
+    any_matcher( M const & match ) : storage(), table( vtable<M>() )
+    {
+        model<M>::create( storage, match );
+    }
+
+    any_matcher( matcher<T> const & match ) : any_matcher( match.copy() ) { }
+
+    any_matcher( Matcher<T> const & match ) : any_matcher( shared_matcher( match ) ) { }
+
+    any_matcher( any_matcher const & other ) : matcher<T>(), storage(), table( other.table )
+    {
+        if ( table )
+            table->clone( other.storage, storage );
+    }
+
+    any_matcher( any_matcher && other ) : matcher<T>(), storage(), table( other.table )
+    {
+        if ( table )
+            table->relocate( other.storage, storage );
+        other.table = nullptr;
+    }
+
+    any_matcher & operator=( any_matcher const & other )
+    {
+        return *this = any_matcher( other );
+    }
+
+    any_matcher & operator=( any_matcher && other )
+    {
+        if ( this != &other )
+        {
+            reset();
+            if ( other.table )
+                other.table->relocate( other.storage, storage );
+            table = other.table; other.table = nullptr;
+        }
+        return *this;
+    }
+
+    ~any_matcher() { reset(); }
+
+    /// true if the matcher is stored in the small buffer.
+    bool is_local() const { return table && table->local; }
+
+    Matcher<T> copy() const { return Matcher<T>( new any_matcher( *this ) ); }
+
+    bool operator()( T const & actual ) const { return table && table->call( storage, actual ); }
+
+    std::string to_string() const { return table ? table->describe( storage ) : ""; }
+
+private:
+    using storage_type = typename std::aligned_storage< buffer_size, alignof( std::max_align_t ) >::type;
+
+    struct vtable_type
+    {
+        bool        local;
+        bool        (*call    )( storage_type const &, T const & );
+        std::string (*describe)( storage_type const & );
+        void        (*clone   )( storage_type const &, storage_type & );
+        void        (*relocate)( storage_type &, storage_type & );
+        void        (*destroy )( storage_type & );
+    };
+
+    // adapt Matcher<T> to a concrete matcher type, for any_matcher( Matcher<T> ):
+
+    struct shared_matcher : matcher<T>
+    {
+        explicit shared_matcher( Matcher<T> const & match ) : match( match ) { }
+
+        Matcher<T> copy() const { return match; }
+
+        bool operator()( T const & actual ) const { return (*match)( actual ); }
+
+        std::string to_string() const { return match->to_string(); }
+
+        Matcher<T> match;
+    };
+
+    template <typename M, bool = ( sizeof(M) <= sizeof(storage_type) && alignof(M) <= alignof(storage_type) )>
+    struct model
+    {
+        static M const & get( storage_type const & s ) { return *reinterpret_cast<M const *>( &s ); }
+
+        static void create( storage_type & s, M const & match ) { new ( &s ) M( match ); }
+
+        static void relocate( storage_type & from, storage_type & to ) { create( to, get( from ) ); destroy( from ); }
+
+        static void destroy( storage_type & s ) { reinterpret_cast<M *>( &s )->~M(); }
+    };
+
+    template <typename M>
+    struct model<M, false>
+    {
+        static M const & get( storage_type const & s ) { return **reinterpret_cast<M * const *>( &s ); }
+
+        static void create( storage_type & s, M const & match ) { new ( &s ) M*( new M( match ) ); }
+
+        static void relocate( storage_type & from, storage_type & to ) { new ( &to ) M*( *reinterpret_cast<M **>( &from ) ); }
+
+        static void destroy( storage_type & s ) { delete *reinterpret_cast<M **>( &s ); }
     };
 
+    template <typename M>
+    static vtable_type const * vtable()
+    {
+        static const vtable_type table =
+        {
+            sizeof(M) <= sizeof(storage_type) && alignof(M) <= alignof(storage_type),
+            []( storage_type const & s, T const & actual ) { return evaluate( model<M>::get( s ), actual ); },
+            []( storage_type const & s ) { return model<M>::get( s ).to_string(); },
+            []( storage_type const & from, storage_type & to ) { model<M>::create( to, model<M>::get( from ) ); },
+            &model<M>::relocate,
+            &model<M>::destroy,
+        };
+        return &table;
+    }
+
+    void reset()
+    {
+        if ( table )
+            table->destroy( storage );
+        table = nullptr;
+    }
+
+    storage_type storage;
+    vtable_type const * table;
+};
+
 /**
  * comparison( value )
  */
@@ -113,7 +452,7 @@ struct comparison_matcher : matcher<T>
     comparison_matcher( comparison_matcher<T> const & ) = default;
     comparison_matcher<T>& operator=( comparison_matcher<T> const & ) = default;
 
-    std::string to_string() const { return text + " " + lest::to_string( expected ); }
+    std::string to_string() const { return text + " " + bounded_string( expected ); }
 
     const std::string text;
     const T expected;
@@ -128,11 +467,25 @@ struct comparison_matcher : matcher<T>
         Matcher<T> copy() const { return Matcher<T>( new matcher_name( *this ) ); } \
         \
         bool operator()( T const & actual ) const { return actual op this->expected; } \
-    };  \
-        \
-    LEST_TAG_MATCHER( matcher_name )
+    };
+
+/**
+ * equal_to( value ); a mismatch of sequences is described by their
+ * differences rather than by all their elements.
+ */
+template <typename T>
+struct equal_to_matcher : comparison_matcher<T>
+{
+    equal_to_matcher( T const & expected ) : comparison_matcher<T>( "is equal to", expected ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new equal_to_matcher( *this ) ); }
+
+    bool operator()( T const & actual ) const { return actual == this->expected; }
+
+    template <typename C>
+    auto describe_mismatch( C const & actual ) const -> ForSequence<C, std::string> { return describe_differences( actual, this->expected ); }
+};
 
-LEST_COMPARISON_MATCHER( ==, equal_to_matcher     , "is equal to" );
 LEST_COMPARISON_MATCHER( !=, not_equal_to_matcher , "is not equal to" );
 
 LEST_COMPARISON_MATCHER( < , less_than_matcher    , "is less than" );
@@ -176,6 +529,75 @@ struct same_instance_matcher : matcher<T>
     const T & instance;
 };
 
+/**
+ * text_view: non-owning view of contiguous characters, so that textual
+ * matchers accept std::string, char *, std::vector<char>, std::string_view
+ * and the like without copying.
+ */
+struct text_view
+{
+    char const * data;
+    std::size_t size;
+};
+
+inline text_view to_text_view( char const * text )
+{
+    return text_view{ text, text ? std::char_traits<char>::length( text ) : 0 };
+}
+
+template <typename S>
+inline auto to_text_view( S const & text ) -> decltype( text_view{ text.data(), text.size() } )
+{
+    return text_view{ text.data(), text.size() };
+}
+
+template <typename S, typename = void>
+struct is_text : std::false_type { };
+
+template <typename S>
+struct is_text< S, decltype( void( to_text_view( std::declval<typename std::decay<S>::type const &>() ) ) ) > : std::true_type { };
+
+template <typename S, typename R>
+using ForText = typename std::enable_if< is_text<S>::value, R>::type;
+
+/**
+ * position of text in actual, or actual.size if absent.
+ */
+inline std::size_t find_text( text_view actual, text_view text )
+{
+    return find_text( actual.data, actual.size, text.data, text.size );
+}
+
+inline bool starts_with_text( text_view actual, text_view text )
+{
+    return actual.size >= text.size && 0 == std::char_traits<char>::compare( actual.data, text.data, text.size );
+}
+
+// prefix check of a null-terminated actual without determining its length:
+
+inline bool starts_with_text( char const * actual, text_view text )
+{
+    if ( ! actual )
+        return false;
+
+    for ( std::size_t i = 0; i < text.size; ++i )
+    {
+        if ( actual[i] != text.data[i] || actual[i] == '\0' )
+            return false;
+    }
+    return true;
+}
+
+inline bool ends_with_text( text_view actual, text_view text )
+{
+    return actual.size >= text.size && 0 == std::char_traits<char>::compare( actual.data + actual.size - text.size, text.data, text.size );
+}
+
+inline bool contains_text( text_view actual, text_view text )
+{
+    return text.size == 0 || find_text( actual, text ) != actual.size;
+}
+
 /**
  * starts_with( text )
  */
@@ -185,7 +607,12 @@ struct starts_with_matcher : public matcher<std::string>
 
     Matcher<std::string> copy() const { return Matcher<std::string>( new starts_with_matcher( *this ) ); }
 
-    bool operator()( std::string const & actual ) const { return 0 == actual.find( text ); }
+    bool operator()( std::string const & actual ) const { return starts_with_text( to_text_view( actual ), to_text_view( text ) ); }
+
+    bool operator()( char const * actual ) const { return starts_with_text( actual, to_text_view( text ) ); }
+
+    template <typename S>
+    auto operator()( S const & actual ) const -> ForText<S, bool> { return starts_with_text( to_text_view( actual ), to_text_view( text ) ); }
 
     std::string to_string() const { return "starts with " + lest::to_string( text ); }
 
@@ -201,7 +628,10 @@ struct ends_with_matcher : public matcher<std::string>
 
     Matcher<std::string> copy() const { return Matcher<std::string>( new ends_with_matcher( *this ) ); }
 
-    bool operator()( std::string const & actual ) const { return actual.find( text ) == actual.size() - text.size(); }
+    bool operator()( std::string const & actual ) const { return ends_with_text( to_text_view( actual ), to_text_view( text ) ); }
+
+    template <typename S>
+    auto operator()( S const & actual ) const -> ForText<S, bool> { return ends_with_text( to_text_view( actual ), to_text_view( text ) ); }
 
     std::string to_string() const { return "ends with " + lest::to_string( text ); }
 
@@ -217,7 +647,10 @@ struct contains_string_matcher : public matcher<std::string>
 
     Matcher<std::string> copy() const { return Matcher<std::string>( new contains_string_matcher( *this ) ); }
 
-    bool operator()(std::string const & actual) const { return std::string::npos != actual.find( text ); }
+    bool operator()( std::string const & actual ) const { return contains_text( to_text_view( actual ), to_text_view( text ) ); }
+
+    template <typename S>
+    auto operator()( S const & actual ) const -> ForText<S, bool> { return contains_text( to_text_view( actual ), to_text_view( text ) ); }
 
     std::string to_string() const { return "contains " + lest::to_string( text ); }
 
@@ -225,343 +658,1998 @@ struct contains_string_matcher : public matcher<std::string>
 };
 
 /**
- * contains_regexp( expr )
+ * aho_corasick: automaton to find any of several texts in a single pass.
  */
-struct contains_regexp_matcher : public matcher<std::string>
+class aho_corasick
 {
-    explicit contains_regexp_matcher( std::string const & expr ) : expr(expr) { }
+public:
+    explicit aho_corasick( std::vector<std::string> const & texts )
+    : next( 1 ), output( 1 ), accepting()
+    {
+        next[0].fill( -1 );
 
-    Matcher<std::string> copy() const { return Matcher<std::string>( new contains_regexp_matcher( *this ) ); }
+        for ( std::size_t i = 0; i < texts.size(); ++i )
+            insert( texts[i], static_cast<int>( i ) );
 
-    bool operator()( std::string const & actual ) const { return std::regex_search( actual, std::regex(expr) ); }
+        link();
+    }
 
-    std::string to_string() const { return "contains " + lest::to_string( expr ); }
+    /// call found( index ) for each text that ends at the scanned position, until found returns true.
+    template <typename F>
+    void scan( text_view actual, F found ) const
+    {
+        int state = 0;
 
-    const std::string expr;
-};
+        if ( report( state, found ) )
+            return;
 
-/**
- * matches_regexp( expr )
- */
-struct match_regexp_matcher : public matcher<std::string>
-{
-    explicit match_regexp_matcher( std::string const & expr ) : expr(expr) { }
+        for ( std::size_t i = 0; i < actual.size; ++i )
+        {
+            state = next[ static_cast<std::size_t>( state ) ][ static_cast<unsigned char>( actual.data[i] ) ];
 
-    Matcher<std::string> copy() const { return Matcher<std::string>( new match_regexp_matcher( *this ) ); }
+            if ( accepting[ static_cast<std::size_t>( state ) ] && report( state, found ) )
+                return;
+        }
+    }
 
-    bool operator()( std::string const & actual ) const { return std::regex_match( actual, std::regex(expr) ); }
+private:
+    void insert( std::string const & text, int index )
+    {
+        std::size_t state = 0;
 
-    std::string to_string() const { return "matches " + lest::to_string( expr ); }
+        for ( auto chr : text )
+        {
+            const std::size_t c = static_cast<unsigned char>( chr );
+
+            if ( next[ state ][ c ] < 0 )
+            {
+                // note: growing next invalidates references into it
+                next[ state ][ c ] = static_cast<int>( next.size() );
+                next.emplace_back(); next.back().fill( -1 );
+                output.emplace_back();
+            }
+            state = static_cast<std::size_t>( next[ state ][ c ] );
+        }
+        output[ state ].push_back( index );
+    }
 
-    const std::string expr;
-};
+    // complete the transition function via failure links, breadth first:
 
-/**
- * contains( element ).
- */
-template <typename T>
-struct contains_element_matcher : public matcher<T>
-{
-    explicit contains_element_matcher( T const & element ) : element( element ) { }
+    void link()
+    {
+        std::vector<int> fail( next.size(), 0 );
+        std::vector<std::size_t> queue;
 
-    Matcher<T> copy() const { return Matcher<T>( new contains_element_matcher( *this ) ); }
+        accepting.assign( next.size(), false );
+        accepting[0] = ! output[0].empty();
 
-    template <typename C>
-    bool operator()( C const & cont ) const { return end(cont) != std::find( begin(cont), end(cont), element ); }
+        for ( auto & to : next[0] )
+        {
+            if ( to < 0 )
+                to = 0;
+            else
+                queue.push_back( static_cast<std::size_t>( to ) );
+        }
 
-    std::string to_string() const { return "contains " + lest::to_string( element ); }
+        for ( std::size_t head = 0; head < queue.size(); ++head )
+        {
+            const std::size_t state = queue[ head ];
+            const std::size_t back  = static_cast<std::size_t>( fail[ state ] );
+
+            output[ state ].insert( output[ state ].end(), output[ back ].begin(), output[ back ].end() );
+            accepting[ state ] = ! output[ state ].empty();
+
+            for ( std::size_t chr = 0; chr < 256; ++chr )
+            {
+                int & to = next[ state ][ chr ];
+
+                if ( to < 0 )
+                {
+                    to = next[ back ][ chr ];
+                }
+                else
+                {
+                    fail[ static_cast<std::size_t>( to ) ] = next[ back ][ chr ];
+                    queue.push_back( static_cast<std::size_t>( to ) );
+                }
+            }
+        }
+    }
 
-    const T element;
+    template <typename F>
+    bool report( int state, F & found ) const
+    {
+        for ( auto index : output[ static_cast<std::size_t>( state ) ] )
+        {
+            if ( found( static_cast<std::size_t>( index ) ) )
+                return true;
+        }
+        return false;
+    }
+
+    std::vector<std::array<int, 256>> next;
+    std::vector<std::vector<int>> output;
+    std::vector<char> accepting;
 };
 
 /**
- * contains( matcher ).
+ * set found[i] for each of texts that occurs in actual, scanning actual once;
+ * stops as soon as done( count of found texts ) is true. Each block of 16
+ * positions is compared with the distinct first characters of the pending
+ * texts at once; only on a hit the first and the last character of each
+ * pending text are compared and candidates are verified.
  */
-template <typename T>
-struct contains_matcher : matcher<T>
+template <typename F>
+inline void find_texts( text_view actual, std::vector<text_view> const & texts, std::vector<bool> & found, F done )
 {
-    explicit contains_matcher( matcher<T> const & match ) : match( match.copy() ) { }
-
-    Matcher<T> copy() const { return Matcher<T>( new contains_matcher( *this)  ); }
+    std::size_t count = 0;
 
-    template <typename C>
-    bool operator()( C const & cont ) const 
-    { 
+    auto mark = [&]( std::size_t index )
+    {
+        if ( ! found[ index ] )
+        {
+            found[ index ] = true; ++count;
+        }
+        return done( count );
+    };
+
+    std::vector<std::size_t> pending;
+    std::size_t longest = 0;
+
+    for ( std::size_t i = 0; i < texts.size(); ++i )
+    {
+        if ( texts[i].size == 0 )
+        {
+            if ( mark( i ) )
+                return;
+        }
+        else if ( texts[i].size <= actual.size )
+        {
+            pending.push_back( i );
+            longest = (std::max)( longest, texts[i].size );
+        }
+    }
+
+    std::size_t pos = 0;
+
+#if lest_FEATURE_SIMD_SEARCH
+    struct lane { __m128i chars; };
+    struct probe { lane first, last; };
+
+    std::vector<probe> probes( texts.size() );
+    std::vector<lane> heads;
+    std::string distinct;
+
+    for ( auto index : pending )
+    {
+        text_view const & text = texts[ index ];
+
+        probes[ index ] = probe{ { _mm_set1_epi8( text.data[0] ) }, { _mm_set1_epi8( text.data[ text.size - 1 ] ) } };
+
+        if ( distinct.find( text.data[0] ) == std::string::npos )
+        {
+            distinct += text.data[0]; heads.push_back( probes[ index ].first );
+        }
+    }
+
+    // a single remaining text is searched faster on its own, see find_text():
+
+    for ( ; pending.size() > 1 && pos + longest - 1 + 16 <= actual.size; pos += 16 )
+    {
+        const __m128i block_first = _mm_loadu_si128( reinterpret_cast<__m128i const *>( actual.data + pos ) );
+
+        __m128i any_first = _mm_setzero_si128();
+        for ( auto const & head : heads )
+            any_first = _mm_or_si128( any_first, _mm_cmpeq_epi8( block_first, head.chars ) );
+
+        if ( 0 == _mm_movemask_epi8( any_first ) )
+            continue;
+
+        for ( std::size_t k = 0; k < pending.size(); )
+        {
+            text_view const & text = texts[ pending[k] ];
+            probe const & chars = probes[ pending[k] ];
+
+            const __m128i block_last = _mm_loadu_si128( reinterpret_cast<__m128i const *>( actual.data + pos + text.size - 1 ) );
+
+            const __m128i eq_first = _mm_cmpeq_epi8( block_first, chars.first.chars );
+            const __m128i eq_last  = _mm_cmpeq_epi8( block_last , chars.last.chars  );
+
+            bool hit = false;
+            for ( unsigned mask = static_cast<unsigned>( _mm_movemask_epi8( _mm_and_si128( eq_first, eq_last ) ) ); mask != 0 && ! hit; mask &= mask - 1 )
+            {
+                hit = 0 == std::memcmp( actual.data + pos + static_cast<std::size_t>( lowest_bit( mask ) ), text.data, text.size );
+            }
+
+            if ( ! hit )
+            {
+                ++k; continue;
+            }
+
+            if ( mark( pending[k] ) )
+                return;
+
+            pending[k] = pending.back(); pending.pop_back();
+        }
+    }
+#endif
+    // remaining texts, or all without SIMD, one by one from where the scan stopped:
+
+    const text_view rest{ actual.data + pos, actual.size - pos };
+
+    for ( auto index : pending )
+    {
+        if ( contains_text( rest, texts[ index ] ) && mark( index ) )
+            return;
+    }
+}
+
+/**
+ * base class for multi-text matchers, contains_any_of(), contains_all_of();
+ * a few texts are searched in a single shared scan via find_texts(), more
+ * via an Aho-Corasick automaton that is built once and shared by copies.
+ */
+struct contains_texts_matcher : public matcher<std::string>
+{
+    enum { automaton_threshold = 32 };
+
+    explicit contains_texts_matcher( std::vector<std::string> const & texts )
+    : texts( texts )
+    , automaton( texts.size() > automaton_threshold ? std::make_shared<const aho_corasick>( texts ) : nullptr ) { }
+
+    /// per text, whether it occurs in actual; stops early when done( found ) is true.
+    template <typename F>
+    std::vector<bool> find( text_view actual, F done ) const
+    {
+        std::vector<bool> found( texts.size(), false );
+        std::size_t count = 0;
+
+        if ( done( count ) )
+            return found;
+
+        if ( ! automaton )
+        {
+            std::vector<text_view> views;
+            for ( auto const & text : texts )
+                views.push_back( to_text_view( text ) );
+
+            find_texts( actual, views, found, done );
+            return found;
+        }
+
+        automaton->scan( actual, [&]( std::size_t index )
+        {
+            if ( ! found[ index ] )
+            {
+                found[ index ] = true; ++count;
+            }
+            return done( count );
+        });
+        return found;
+    }
+
+    /// the texts that are (not) present in actual.
+    std::vector<std::string> select( text_view actual, bool present ) const
+    {
+        const std::vector<bool> found = find( actual, [this]( std::size_t count ) { return count == texts.size(); } );
+
+        std::vector<std::string> result;
+        for ( std::size_t i = 0; i < texts.size(); ++i )
+        {
+            if ( found[i] == present )
+                result.push_back( texts[i] );
+        }
+        return result;
+    }
+
+    const std::vector<std::string> texts;
+    const std::shared_ptr<const aho_corasick> automaton;
+};
+
+/**
+ * contains_any_of( {text...} ).
+ */
+struct contains_any_of_matcher : public contains_texts_matcher
+{
+    explicit contains_any_of_matcher( std::vector<std::string> const & texts ) : contains_texts_matcher( texts ) { }
+
+    Matcher<std::string> copy() const { return Matcher<std::string>( new contains_any_of_matcher( *this ) ); }
+
+    bool operator()( std::string const & actual ) const { return matches( to_text_view( actual ) ); }
+
+    template <typename S>
+    auto operator()( S const & actual ) const -> ForText<S, bool> { return matches( to_text_view( actual ) ); }
+
+    template <typename S>
+    auto describe_mismatch( S const & actual ) const -> ForText<S, std::string> { return matches( to_text_view( actual ) ) ? "" : "none found"; }
+
+    std::string to_string() const { return "contains any of " + lest::to_string( texts ); }
+
+private:
+    bool matches( text_view actual ) const
+    {
+        const std::vector<bool> found = find( actual, []( std::size_t count ) { return count > 0; } );
+        return std::find( found.begin(), found.end(), true ) != found.end();
+    }
+};
+
+/**
+ * contains_all_of( {text...} ).
+ */
+struct contains_all_of_matcher : public contains_texts_matcher
+{
+    explicit contains_all_of_matcher( std::vector<std::string> const & texts ) : contains_texts_matcher( texts ) { }
+
+    Matcher<std::string> copy() const { return Matcher<std::string>( new contains_all_of_matcher( *this ) ); }
+
+    bool operator()( std::string const & actual ) const { return matches( to_text_view( actual ) ); }
+
+    template <typename S>
+    auto operator()( S const & actual ) const -> ForText<S, bool> { return matches( to_text_view( actual ) ); }
+
+    template <typename S>
+    auto describe_mismatch( S const & actual ) const -> ForText<S, std::string>
+    {
+        const std::vector<std::string> missing = select( to_text_view( actual ), false );
+        return missing.empty() ? "" : "missing " + lest::to_string( missing );
+    }
+
+    std::string to_string() const { return "contains all of " + lest::to_string( texts ); }
+
+private:
+    bool matches( text_view actual ) const
+    {
+        const std::vector<bool> found = find( actual, [this]( std::size_t count ) { return count == texts.size(); } );
+        return std::find( found.begin(), found.end(), false ) == found.end();
+    }
+};
+
+/**
+ * is_text_predicate<M>: textual matcher that all_of() and any_of() can fuse.
+ */
+template <typename M>
+struct is_text_predicate : std::integral_constant< bool,
+    std::is_same<M, starts_with_matcher>::value || std::is_same<M, ends_with_matcher>::value || std::is_same<M, contains_string_matcher>::value > { };
+
+template <typename... Ms>
+struct are_text_predicates : std::true_type { };
+
+template <typename M, typename... Ms>
+struct are_text_predicates<M, Ms...> : std::integral_constant< bool, is_text_predicate<M>::value && are_text_predicates<Ms...>::value > { };
+
+/**
+ * text_predicates: the textual matchers of all_of( matcher... ) or
+ * any_of( matcher... ), evaluated together. Prefixes and suffixes are checked
+ * first, then all contained texts are searched in a single scan over the
+ * actual string that stops as soon as the outcome is known.
+ */
+class text_predicates
+{
+public:
+    template <typename... Ms>
+    static text_predicates make( Ms const &... ms )
+    {
+        return text_predicates( parts().add( ms... ) );
+    }
+
+    bool all_of( text_view actual ) const
+    {
+        for ( auto const & text : prefixes )
+            if ( ! starts_with_text( actual, to_text_view( text ) ) ) return false;
+
+        for ( auto const & text : suffixes )
+            if ( ! ends_with_text( actual, to_text_view( text ) ) ) return false;
+
+        const std::vector<bool> found = infixes.find( actual, [this]( std::size_t count ) { return count == infixes.texts.size(); } );
+        return std::find( found.begin(), found.end(), false ) == found.end();
+    }
+
+    bool any_of( text_view actual ) const
+    {
+        for ( auto const & text : prefixes )
+            if ( starts_with_text( actual, to_text_view( text ) ) ) return true;
+
+        for ( auto const & text : suffixes )
+            if ( ends_with_text( actual, to_text_view( text ) ) ) return true;
+
+        const std::vector<bool> found = infixes.find( actual, []( std::size_t count ) { return count > 0; } );
+        return std::find( found.begin(), found.end(), true ) != found.end();
+    }
+
+private:
+    struct parts
+    {
+        std::vector<std::string> prefixes, suffixes, infixes;
+
+        parts() : prefixes(), suffixes(), infixes() { }
+
+        parts & add() { return *this; }
+
+        template <typename... Ms>
+        parts & add( starts_with_matcher const & m, Ms const &... ms ) { prefixes.push_back( m.text ); return add( ms... ); }
+
+        template <typename... Ms>
+        parts & add( ends_with_matcher const & m, Ms const &... ms ) { suffixes.push_back( m.text ); return add( ms... ); }
+
+        template <typename... Ms>
+        parts & add( contains_string_matcher const & m, Ms const &... ms ) { infixes.push_back( m.text ); return add( ms... ); }
+    };
+
+    explicit text_predicates( parts const & p ) : prefixes( p.prefixes ), suffixes( p.suffixes ), infixes( p.infixes ) { }
+
+    std::vector<std::string> prefixes;
+    std::vector<std::string> suffixes;
+    contains_all_of_matcher infixes;
+};
+
+/**
+ * no_text_predicates: stand-in for compositions that cannot be fused.
+ */
+struct no_text_predicates
+{
+    template <typename... Ms>
+    static no_text_predicates make( Ms const &... ) { return no_text_predicates(); }
+};
+
+/**
+ * regex engine selection; linear falls back to std::regex for constructs it
+ * does not support. Define lest_FEATURE_LINEAR_REGEX to 1 to use it by default.
+ */
+enum class regex_engine { standard, linear };
+
+const regex_engine default_regex_engine = lest_FEATURE_LINEAR_REGEX ? regex_engine::linear : regex_engine::standard;
+
+/**
+ * compiled regular expression, using the selected engine.
+ */
+class regexp
+{
+public:
+    regexp( std::string const & expr, std::regex::flag_type flags, regex_engine engine )
+    : linear( make_linear( expr, flags, engine ) )
+    , standard( linear ? nullptr : new std::regex( expr, flags ) ) { }
+
+    bool is_linear() const { return !! linear; }
+
+    bool match ( std::string const & text ) const { return linear ? linear->match ( text ) : std::regex_match ( text, *standard ); }
+
+    bool search( std::string const & text ) const { return linear ? linear->search( text ) : std::regex_search( text, *standard ); }
+
+private:
+    static std::unique_ptr<linear_regex> make_linear( std::string const & expr, std::regex::flag_type flags, regex_engine engine )
+    {
+        const auto other = ~( std::regex::ECMAScript | std::regex::icase | std::regex::nosubs | std::regex::optimize );
+
+        if ( engine != regex_engine::linear || ( flags & other ) != std::regex::flag_type() )
+            return nullptr;
+
+        try
+        {
+            return std::unique_ptr<linear_regex>( new linear_regex( expr, ( flags & std::regex::icase ) == std::regex::icase ) );
+        }
+        catch ( regex_unsupported const & )
+        {
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<linear_regex> linear;
+    std::unique_ptr<std::regex> standard;
+};
+
+using Regex = std::shared_ptr<const regexp>;
+
+/**
+ * compiled regular expression from process-wide cache keyed by pattern, flags and engine;
+ * the cache keeps the lest_FEATURE_REGEX_CACHE_SIZE most recently used expressions.
+ */
+inline Regex compiled_regex( std::string const & expr, std::regex::flag_type flags, regex_engine engine )
+{
+    using key_t   = std::tuple<std::string, std::regex::flag_type, regex_engine>;
+    using entry_t = std::pair<key_t, Regex>;
+
+    static std::mutex mutex;
+    static std::list<entry_t> recent;
+    static std::map<key_t, std::list<entry_t>::iterator> cache;
+
+    std::lock_guard<std::mutex> lock( mutex );
+
+    const key_t key = std::make_tuple( expr, flags, engine );
+    const auto pos  = cache.find( key );
+
+    if ( pos != cache.end() )
+    {
+        recent.splice( recent.begin(), recent, pos->second );
+        return pos->second->second;
+    }
+
+    Regex regex = std::make_shared<const regexp>( expr, flags, engine );
+
+    recent.emplace_front( key, regex );
+    cache[ key ] = recent.begin();
+
+    if ( recent.size() > lest_FEATURE_REGEX_CACHE_SIZE )
+    {
+        cache.erase( recent.back().first );
+        recent.pop_back();
+    }
+    return regex;
+}
+
+/**
+ * contains_regexp( expr [, flags [, engine]] )
+ */
+struct contains_regexp_matcher : public matcher<std::string>
+{
+    explicit contains_regexp_matcher( std::string const & expr, std::regex::flag_type flags = std::regex::ECMAScript, regex_engine engine = default_regex_engine )
+    : expr( expr ), regex( compiled_regex( expr, flags, engine ) ) { }
+
+    Matcher<std::string> copy() const { return Matcher<std::string>( new contains_regexp_matcher( *this ) ); }
+
+    bool operator()( std::string const & actual ) const { return regex->search( actual ); }
+
+    std::string to_string() const { return "contains " + lest::to_string( expr ); }
+
+    const std::string expr;
+    const Regex regex;
+};
+
+/**
+ * matches_regexp( expr [, flags [, engine]] )
+ */
+struct match_regexp_matcher : public matcher<std::string>
+{
+    explicit match_regexp_matcher( std::string const & expr, std::regex::flag_type flags = std::regex::ECMAScript, regex_engine engine = default_regex_engine )
+    : expr( expr ), regex( compiled_regex( expr, flags, engine ) ) { }
+
+    Matcher<std::string> copy() const { return Matcher<std::string>( new match_regexp_matcher( *this ) ); }
+
+    bool operator()( std::string const & actual ) const { return regex->match( actual ); }
+
+    std::string to_string() const { return "matches " + lest::to_string( expr ); }
+
+    const std::string expr;
+    const Regex regex;
+};
+
+/**
+ * element lookup traits: member find(), hashing and ordering of elements.
+ */
+template <typename C, typename T, typename = void>
+struct has_member_find : std::false_type { };
+
+template <typename C, typename T>
+struct has_member_find< C, T, decltype( void( std::declval<C const &>().find( std::declval<T const &>() ) == std::declval<C const &>().end() ) ) > : std::true_type { };
+
+template <typename T, typename = void>
+struct is_hashable : std::false_type { };
+
+template <typename T>
+struct is_hashable< T, decltype( void( std::hash<T>()( std::declval<T const &>() ) ) ) > : std::true_type { };
+
+template <typename T, typename = void>
+struct is_less_comparable : std::false_type { };
+
+template <typename T>
+struct is_less_comparable< T, decltype( void( bool( std::declval<T const &>() < std::declval<T const &>() ) ) ) > : std::true_type { };
+
+/**
+ * whether cont contains element; via the container's own find() if it has
+ * one, such as std::set, std::unordered_map and sorted_range, else linearly.
+ */
+template <typename C, typename T>
+inline bool contains_element( C const & cont, T const & element, std::true_type )
+{
+    return cont.find( element ) != cont.end();
+}
+
+template <typename C, typename T>
+inline bool contains_element( C const & cont, T const & element, std::false_type )
+{
+    return end(cont) != std::find( begin(cont), end(cont), element );
+}
+
+template <typename C, typename T>
+inline bool contains_element( C const & cont, T const & element )
+{
+    return contains_element( cont, element, has_member_find<C, T>() );
+}
+
+/**
+ * less: default ordering of sorted_range.
+ */
+struct less
+{
+    template <typename T, typename U>
+    bool operator()( T const & a, U const & b ) const { return a < b; }
+};
+
+/**
+ * sorted_range: view of a range that is sorted according to less, with a
+ * binary-search find(); see sorted().
+ */
+template <typename It, typename L = less>
+class sorted_range
+{
+public:
+    using value_type     = typename std::iterator_traits<It>::value_type;
+    using iterator       = It;
+    using const_iterator = It;
+
+    sorted_range( It first, It last, L less ) : first( first ), last( last ), order( less ) { }
+
+    It begin() const { return first; }
+    It end()   const { return last; }
+
+    bool empty() const { return first == last; }
+
+    std::size_t size() const { return static_cast<std::size_t>( std::distance( first, last ) ); }
+
+    template <typename T>
+    It find( T const & value ) const
+    {
+        const It pos = std::lower_bound( first, last, value, order );
+        return pos != last && ! order( value, *pos ) ? pos : last;
+    }
+
+private:
+    It first, last;
+    L order;
+};
+
+/**
+ * contains( element ): a lookup via the container's own find() for
+ * associative and hashed containers and for sorted( range ), else a linear
+ * scan; selected at compile time.
+ */
+template <typename T>
+struct contains_element_matcher : public matcher<T>
+{
+    explicit contains_element_matcher( T const & element ) : element( element ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new contains_element_matcher( *this ) ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool> { return contains_element( cont, element ); }
+
+    std::string to_string() const { return "contains " + lest::to_string( element ); }
+
+    const T element;
+};
+
+/**
+ * contains( matcher ).
+ */
+template <typename T>
+struct contains_matcher : matcher<T>
+{
+    explicit contains_matcher( any_matcher<T> const & match ) : match( match ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new contains_matcher( *this)  ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool>
+    {
+        return std::any_of(
+            cont.begin(), cont.end(),
+            [this]( typename C::value_type const & value ) { return match(value); }
+        );
+    }
+
+    std::string to_string() const { return "contains " +  match.to_string(); }
+
+    const any_matcher<T> match;
+};
+
+/**
+ * is_lossless<V, T>: every V value converts to an equal T value, so that
+ * elements of type V can be looked up by their value as T.
+ */
+template <typename V, typename T>
+struct is_lossless : std::integral_constant< bool, std::is_same<V, T>::value ||
+    ( std::is_integral<V>::value && std::is_integral<T>::value && ! std::is_same<V, bool>::value && ! std::is_same<T, bool>::value &&
+      std::numeric_limits<V>::digits <= std::numeric_limits<T>::digits && ( std::is_unsigned<V>::value || std::is_signed<T>::value ) ) > { };
+
+template <typename C, typename = void>
+struct is_contiguous : std::false_type { };
+
+template <typename C>
+struct is_contiguous< C, typename std::enable_if< std::is_pointer< decltype( std::declval<C const &>().data() ) >::value >::type > : std::true_type { };
+
+template <typename C>
+struct is_random_access : std::is_base_of< std::random_access_iterator_tag, typename std::iterator_traits< iterator_of<C> >::iterator_category > { };
+
+/**
+ * horspool_table: Boyer-Moore-Horspool bad-character shifts for a pattern;
+ * a flat table for one- and two-byte integral elements, else a hash map.
+ */
+template <typename T, bool = std::is_integral<T>::value && ! std::is_same<T, bool>::value && sizeof(T) <= 2>
+class horspool_table
+{
+public:
+    explicit horspool_table( std::vector<T> const & pattern ) : shifts(), length( pattern.size() )
+    {
+        for ( std::size_t i = 0; i + 1 < pattern.size(); ++i )
+            shifts[ pattern[i] ] = pattern.size() - 1 - i;
+    }
+
+    std::size_t shift( T const & value ) const
+    {
+        const auto pos = shifts.find( value );
+        return pos == shifts.end() ? length : pos->second;
+    }
+
+private:
+    std::unordered_map<T, std::size_t> shifts;
+    std::size_t length;
+};
+
+template <typename T>
+class horspool_table<T, true>
+{
+public:
+    explicit horspool_table( std::vector<T> const & pattern )
+    : shifts( std::size_t( 1 ) << ( 8 * sizeof(T) ), pattern.size() )
+    {
+        for ( std::size_t i = 0; i + 1 < pattern.size(); ++i )
+            shifts[ index( pattern[i] ) ] = pattern.size() - 1 - i;
+    }
+
+    std::size_t shift( T const & value ) const { return shifts[ index( value ) ]; }
+
+private:
+    static std::size_t index( T const & value ) { return static_cast<typename std::make_unsigned<T>::type>( value ); }
+
+    std::vector<std::size_t> shifts;
+};
+
+/**
+ * contains( sequence ): a vectorised byte search for contiguous ranges of
+ * one-byte integral elements, a Boyer-Moore-Horspool search for larger
+ * random-access ranges of hashable elements, std::search otherwise.
+ */
+template <typename T>
+struct contains_sequence_matcher : public matcher<T>
+{
+    enum { horspool_threshold = 256 };
+
+    explicit contains_sequence_matcher( std::initializer_list<T> const & sequence ) : sequence( sequence ), table() { }
+
+    explicit contains_sequence_matcher( std::vector<T> const & sequence ) : sequence( sequence ), table() { }
+
+    contains_sequence_matcher( contains_sequence_matcher const & other )
+    : matcher<T>( other ), sequence( other.sequence ), table( std::atomic_load( &other.table ) ) { }
+
+    contains_sequence_matcher( contains_sequence_matcher && other )
+    : matcher<T>( other ), sequence( other.sequence ), table( std::move( other.table ) ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new contains_sequence_matcher( *this ) ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool>
+    {
+        return search( cont, search_tag<C>() );
+    }
+
+    std::string to_string() const { return "contains " + lest::to_string( sequence ); }
+
+    const std::vector<T> sequence;
+
+private:
+    // the shift table is built by the first Horspool search and shared with later copies of the matcher:
+
+    std::shared_ptr<const horspool_table<T>> shift_table() const
+    {
+        auto result = std::atomic_load( &table );
+
+        if ( ! result )
+        {
+            result = std::make_shared<const horspool_table<T>>( sequence );
+            std::atomic_store( &table, result );
+        }
+        return result;
+    }
+
+    mutable std::shared_ptr<const horspool_table<T>> table;
+
+    template <typename C>
+    using search_tag = std::integral_constant<int,
+        ! is_lossless<element_of<C>, T>::value ? 0 :
+        is_contiguous<C>::value && std::is_integral<element_of<C>>::value && sizeof( element_of<C> ) == 1 ? 2 :
+        is_random_access<C>::value && is_hashable<T>::value ? 1 : 0 >;
+
+    template <typename C>
+    bool search( C const & cont, std::integral_constant<int, 0> ) const
+    {
+        return std::end( cont ) != std::search( std::begin( cont ), std::end( cont ), sequence.begin(), sequence.end() );
+    }
+
+    // elements that compare equal to the pattern as T have its bytes:
+
+    template <typename C>
+    bool search( C const & cont, std::integral_constant<int, 2> ) const
+    {
+        using V = element_of<C>;
+
+        std::string bytes( sequence.size(), '\0' );
+        for ( std::size_t i = 0; i < sequence.size(); ++i )
+        {
+            const V value = static_cast<V>( sequence[i] );
+
+            if ( value != sequence[i] )
+                return false;
+
+            std::memcpy( &bytes[i], &value, 1 );
+        }
+
+        const std::size_t size = static_cast<std::size_t>( std::distance( std::begin( cont ), std::end( cont ) ) );
+
+        return size != find_text( reinterpret_cast<char const *>( cont.data() ), size, bytes.data(), bytes.size() );
+    }
+
+    template <typename C>
+    bool search( C const & cont, std::integral_constant<int, 1> ) const
+    {
+        const auto first = std::begin( cont );
+        const std::size_t n = static_cast<std::size_t>( std::end( cont ) - first );
+        const std::size_t m = sequence.size();
+
+        if ( m == 0 || n < horspool_threshold )
+            return search( cont, std::integral_constant<int, 0>() );
+
+        const auto table = shift_table();
+
+        for ( std::size_t pos = 0; pos + m <= n; )
+        {
+            const T last = static_cast<T>( first[ pos + m - 1 ] );
+
+            if ( last == sequence[ m - 1 ] && std::equal( sequence.begin(), sequence.end() - 1, first + pos ) )
+                return true;
+
+            pos += table->shift( last );
+        }
+        return false;
+    }
+};
+
+/**
+ * contains_elements( list ): the container's own find() for associative
+ * containers, a linear scan per element for a few elements, otherwise a
+ * single pass over the container that looks up its elements in a hash set
+ * or a sorted copy of the list.
+ */
+template <typename T>
+struct contains_elements_matcher : public matcher<T>
+{
+    enum { linear_threshold = 8 };
+
+    explicit contains_elements_matcher( std::initializer_list<T> const & list ) : list( list ) { }
+
+    explicit contains_elements_matcher( std::vector<T> const & list ) : list( list ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new contains_elements_matcher( *this ) ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool> { return missing( cont, false ).empty(); }
+
+    template <typename C>
+    auto describe_mismatch( C const & cont ) const -> ForContainer<C, std::string>
+    {
+        const std::vector<T> absent = missing( cont, true );
+        return absent.empty() ? "" : "missing " + lest::to_string( absent );
+    }
+
+    std::string to_string() const { return "contains elements " + lest::to_string( list ); }
+
+    const std::vector<T> list;
+
+private:
+    using lookup_tag = std::integral_constant<int,
+        is_hashable<T>::value ? 2 : is_less_comparable<T>::value ? 1 : 0>;
+
+    /// the elements of list that cont lacks; only the first one unless all.
+    template <typename C>
+    std::vector<T> missing( C const & cont, bool all ) const
+    {
+        std::vector<bool> found( list.size(), false );
+
+        if ( has_member_find<C, T>::value || list.size() <= linear_threshold )
+            find_each( cont, found, all );
+        else
+            find_all( cont, found, lookup_tag() );
+
+        std::vector<T> result;
+        for ( std::size_t i = 0; i < list.size() && ( all || result.empty() ); ++i )
+        {
+            if ( ! found[i] )
+                result.push_back( list[i] );
+        }
+        return result;
+    }
+
+    // look up element by element, via member find() or a linear scan:
+
+    template <typename C>
+    void find_each( C const & cont, std::vector<bool> & found, bool all ) const
+    {
+        for ( std::size_t i = 0; i < list.size(); ++i )
+        {
+            if ( ! ( found[i] = contains_element( cont, list[i] ) ) && ! all )
+                return;
+        }
+    }
+
+    // single pass over the container, stopping once all elements are found:
+
+    template <typename C>
+    void find_all( C const & cont, std::vector<bool> & found, std::integral_constant<int, 2> ) const
+    {
+        std::unordered_map<T, std::vector<std::size_t>> pending;
+        for ( std::size_t i = 0; i < list.size(); ++i )
+            pending[ list[i] ].push_back( i );
+
+        for ( auto pos = begin(cont); pos != end(cont) && ! pending.empty(); ++pos )
+        {
+            auto entry = pending.find( *pos );
+
+            if ( entry == pending.end() )
+                continue;
+
+            for ( auto i : entry->second )
+                found[i] = true;
+
+            pending.erase( entry );
+        }
+    }
+
+    template <typename C>
+    void find_all( C const & cont, std::vector<bool> & found, std::integral_constant<int, 1> ) const
+    {
+        std::vector<std::size_t> order( list.size() );
+        for ( std::size_t i = 0; i < order.size(); ++i )
+            order[i] = i;
+
+        auto less = [this]( std::size_t a, std::size_t b ) { return list[a] < list[b]; };
+        std::sort( order.begin(), order.end(), less );
+
+        std::size_t remaining = list.size();
+
+        for ( auto pos = begin(cont); pos != end(cont) && remaining > 0; ++pos )
+        {
+            T const & value = *pos;
+
+            auto first = std::lower_bound( order.begin(), order.end(), value, [this]( std::size_t i, T const & v ) { return list[i] < v; } );
+
+            for ( ; first != order.end() && ! ( value < list[ *first ] ) && ! found[ *first ]; ++first )
+            {
+                found[ *first ] = true; --remaining;
+            }
+        }
+    }
+
+    template <typename C>
+    void find_all( C const & cont, std::vector<bool> & found, std::integral_constant<int, 0> ) const
+    {
+        find_each( cont, found, true );
+    }
+};
+
+/**
+ * contains_in_any_order( list ), is_permutation_of( cont ),
+ * unordered_equal_to( cont ): the container holds the same elements as
+ * list, as a multiset; counted in a hash map, compared as sorted copies for
+ * elements without std::hash, pairwise otherwise.
+ */
+template <typename T>
+struct contains_in_any_order_matcher : public matcher<T>
+{
+    enum { diff_limit = 10 };
+
+    contains_in_any_order_matcher( std::vector<T> const & list, std::string const & name ) : list( list ), name( name ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new contains_in_any_order_matcher( *this ) ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool>
+    {
+        std::vector<T> surplus, missing;
+        return static_cast<std::size_t>( std::distance( std::begin( cont ), std::end( cont ) ) ) == list.size()
+            && difference( cont, surplus, missing, false );
+    }
+
+    template <typename C>
+    auto describe_mismatch( C const & cont ) const -> ForContainer<C, std::string>
+    {
+        std::vector<T> surplus, missing;
+        if ( difference( cont, surplus, missing, true ) )
+            return "";
+
+        std::string result;
+        if ( ! surplus.empty() ) result += "surplus " + compact_string( surplus, diff_limit );
+        if ( ! surplus.empty() && ! missing.empty() ) result += ", ";
+        if ( ! missing.empty() ) result += "missing " + compact_string( missing, diff_limit );
+        return result;
+    }
+
+    std::string to_string() const { return name + " " + compact_string( list, diff_limit ); }
+
+    const std::vector<T> list;
+    const std::string name;
+
+private:
+    using compare_tag = std::integral_constant<int,
+        is_hashable<T>::value ? 2 : is_less_comparable<T>::value ? 1 : 0>;
+
+    /// true if cont and list hold the same elements; collects the
+    /// differences if all, else stops at the first one.
+    template <typename C>
+    bool difference( C const & cont, std::vector<T> & surplus, std::vector<T> & missing, bool all ) const
+    {
+        difference( cont, surplus, missing, all, compare_tag() );
+        return surplus.empty() && missing.empty();
+    }
+
+    template <typename C>
+    void difference( C const & cont, std::vector<T> & surplus, std::vector<T> & missing, bool all, std::integral_constant<int, 2> ) const
+    {
+        std::unordered_map<T, std::size_t> counts( list.size() );
+        for ( auto const & x : list )
+            ++counts[ x ];
+
+        for ( auto pos = std::begin( cont ); pos != std::end( cont ); ++pos )
+        {
+            const T value = *pos;
+            auto entry = counts.find( value );
+
+            if ( entry != counts.end() && entry->second > 0 )
+            {
+                --entry->second;
+                continue;
+            }
+
+            surplus.push_back( value );
+
+            if ( ! all )
+                return;
+        }
+
+        for ( auto const & x : list )
+        {
+            auto & count = counts[ x ];
+
+            if ( count > 0 )
+            {
+                --count;
+                missing.push_back( x );
+            }
+        }
+    }
+
+    template <typename C>
+    void difference( C const & cont, std::vector<T> & surplus, std::vector<T> & missing, bool all, std::integral_constant<int, 1> ) const
+    {
+        std::vector<T> actual( std::begin( cont ), std::end( cont ) );
+        std::vector<T> expected( list );
+
+        std::sort( actual.begin(), actual.end() );
+        std::sort( expected.begin(), expected.end() );
+
+        auto a = actual.begin();
+        auto e = expected.begin();
+
+        while ( a != actual.end() || e != expected.end() )
+        {
+            if ( ! all && ( ! surplus.empty() || ! missing.empty() ) )
+                return;
+
+            if      ( e == expected.end() || ( a != actual.end() && *a < *e ) ) surplus.push_back( *a++ );
+            else if ( a == actual.end()   || *e < *a                        ) missing.push_back( *e++ );
+            else                                                              { ++a; ++e; }
+        }
+    }
+
+    template <typename C>
+    void difference( C const & cont, std::vector<T> & surplus, std::vector<T> & missing, bool all, std::integral_constant<int, 0> ) const
+    {
+        std::vector<bool> used( list.size(), false );
+
+        for ( auto pos = std::begin( cont ); pos != std::end( cont ); ++pos )
+        {
+            std::size_t i = 0;
+            while ( i < list.size() && ( used[i] || ! ( list[i] == *pos ) ) )
+                ++i;
+
+            if ( i < list.size() )
+            {
+                used[i] = true;
+                continue;
+            }
+
+            surplus.push_back( *pos );
+
+            if ( ! all )
+                return;
+        }
+
+        for ( std::size_t i = 0; i < list.size(); ++i )
+        {
+            if ( ! used[i] )
+                missing.push_back( list[i] );
+        }
+    }
+};
+
+/**
+ * is_empty().
+ */
+struct is_empty_matcher : matcher<int>
+{
+    explicit is_empty_matcher() { }
+
+    Matcher<int> copy() const { return Matcher<int>( new is_empty_matcher() ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool> { return cont.empty(); }
+
+    std::string to_string() const { return "is empty "; }
+};
+
+/**
+ * no_violation: index reported when a sequence has the required property.
+ */
+const std::size_t no_violation = std::size_t( -1 );
+
+/**
+ * describe_violation( cont, index ): the index of the first element that
+ * violates a sequence property, with the elements around it.
+ */
+template <typename C>
+inline std::string describe_violation( C const & cont, std::size_t index, std::size_t radius = 2 )
+{
+    if ( index == no_violation )
+        return "";
+
+    std::ostringstream os;
+    os << "violated at index " << index << ": " << window_string( cont, index, radius );
+    return os.str();
+}
+
+/**
+ * is_sorted( [less] ), is_strictly_increasing( [less] ): each element is
+ * not less than, respectively greater than, its predecessor.
+ */
+template <typename L = less>
+struct is_sorted_matcher : matcher<int>
+{
+    is_sorted_matcher( L order, bool strict ) : order( order ), strict( strict ) { }
+
+    Matcher<int> copy() const { return Matcher<int>( new is_sorted_matcher( *this ) ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool> { return violation( cont ) == no_violation; }
+
+    template <typename C>
+    auto describe_mismatch( C const & cont ) const -> ForContainer<C, std::string> { return describe_violation( cont, violation( cont ) ); }
+
+    std::string to_string() const { return strict ? "is strictly increasing" : "is sorted"; }
+
+    const L order;
+    const bool strict;
+
+private:
+    template <typename C>
+    std::size_t violation( C const & cont ) const
+    {
+        using V = element_of<C>;
+
+        const auto pos = std::adjacent_find( std::begin( cont ), std::end( cont ),
+            [this]( V const & a, V const & b ) { return strict ? ! order( a, b ) : order( b, a ); } );
+
+        return pos == std::end( cont ) ? no_violation : static_cast<std::size_t>( std::distance( std::begin( cont ), pos ) ) + 1;
+    }
+};
+
+/**
+ * has_unique_elements(): no element occurs twice; checked against a hash
+ * set, an ordered set for elements without std::hash, pairwise otherwise.
+ */
+struct has_unique_elements_matcher : matcher<int>
+{
+    explicit has_unique_elements_matcher() { }
+
+    Matcher<int> copy() const { return Matcher<int>( new has_unique_elements_matcher() ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool> { return violation( cont ) == no_violation; }
+
+    template <typename C>
+    auto describe_mismatch( C const & cont ) const -> ForContainer<C, std::string> { return describe_violation( cont, violation( cont ) ); }
+
+    std::string to_string() const { return "has unique elements"; }
+
+private:
+    template <typename C>
+    using lookup_tag = std::integral_constant<int,
+        is_hashable<element_of<C>>::value ? 2 : is_less_comparable<element_of<C>>::value ? 1 : 0>;
+
+    template <typename C>
+    static std::size_t violation( C const & cont ) { return violation( cont, lookup_tag<C>() ); }
+
+    template <typename C>
+    static std::size_t violation( C const & cont, std::integral_constant<int, 2> )
+    {
+        std::unordered_set<element_of<C>> seen;
+
+        if ( is_random_access<C>::value )
+            seen.reserve( static_cast<std::size_t>( std::distance( std::begin( cont ), std::end( cont ) ) ) );
+
+        return first_repeated( cont, seen );
+    }
+
+    template <typename C>
+    static std::size_t violation( C const & cont, std::integral_constant<int, 1> )
+    {
+        std::set<element_of<C>> seen;
+        return first_repeated( cont, seen );
+    }
+
+    template <typename C>
+    static std::size_t violation( C const & cont, std::integral_constant<int, 0> )
+    {
+        std::size_t i = 0;
+        for ( auto pos = std::begin( cont ); pos != std::end( cont ); ++pos, ++i )
+        {
+            if ( std::find( std::begin( cont ), pos, *pos ) != pos )
+                return i;
+        }
+        return no_violation;
+    }
+
+    template <typename C, typename S>
+    static std::size_t first_repeated( C const & cont, S & seen )
+    {
+        std::size_t i = 0;
+        for ( auto pos = std::begin( cont ); pos != std::end( cont ); ++pos, ++i )
+        {
+            if ( ! seen.insert( *pos ).second )
+                return i;
+        }
+        return no_violation;
+    }
+};
+
+/**
+ * is_heap( [less] ): a random-access range that is a max-heap for less.
+ */
+template <typename L = less>
+struct is_heap_matcher : matcher<int>
+{
+    explicit is_heap_matcher( L order ) : order( order ) { }
+
+    Matcher<int> copy() const { return Matcher<int>( new is_heap_matcher( *this ) ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool> { return violation( cont ) == no_violation; }
+
+    template <typename C>
+    auto describe_mismatch( C const & cont ) const -> ForContainer<C, std::string> { return describe_violation( cont, violation( cont ) ); }
+
+    std::string to_string() const { return "is heap"; }
+
+    const L order;
+
+private:
+    template <typename C>
+    std::size_t violation( C const & cont ) const
+    {
+        const auto pos = std::is_heap_until( std::begin( cont ), std::end( cont ), order );
+
+        return pos == std::end( cont ) ? no_violation : static_cast<std::size_t>( pos - std::begin( cont ) );
+    }
+};
+
+/**
+ * size_is().
+ */
+template <typename T>
+struct size_is_matcher : matcher<T>
+{
+    size_is_matcher( T const & size ) : match( equal_to_matcher<T>( size ) ) { }
+
+    explicit size_is_matcher( any_matcher<T> const & match ) : match( match ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new size_is_matcher( *this)  ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool> { return match( cont.size() ); }
+
+    std::string to_string() const { return "size " +  match.to_string(); }
+
+    const any_matcher<T> match;
+};
+
+/**
+ * anything( [description] ): match anything of type T.
+ */
+template <typename T>
+struct anything : matcher<T>
+{
+    explicit anything( std::string description = "[anything]" ) : description( description ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new anything(*this) ); }
+
+    bool operator()( T const & /*actual*/ ) const { return true; }
+
+    std::string to_string() const { return lest::to_string( description ); }
+
+    const std::string description;
+};
+
+/**
+ * is( matcher ), is( value )
+ */
+template <typename T>
+struct is_matcher : matcher<T>
+{
+    is_matcher( T value ) : match( equal_to_matcher<T>( value ) ) { }
+
+    explicit is_matcher( any_matcher<T> const & match ) : match( match ) { }
+
+    Matcher<T> copy() const { return match.copy(); }
+
+    bool operator()( T const & actual ) const { return match( actual ); }
+
+    std::string to_string() const { return match.to_string(); }
+
+    const any_matcher<T> match;
+};
+
+/**
+ * is_not( matcher ), is_not( value )
+ */
+template <typename T>
+struct is_not_matcher : matcher<T>
+{
+    is_not_matcher( T value ) : match( equal_to_matcher<T>( value ) ) { }
+
+    explicit is_not_matcher( any_matcher<T> const & match ) : match( match ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new is_not_matcher( *this ) ); }
+
+    bool operator()( T const & actual ) const { return ! match( actual ); }
+
+    std::string to_string() const { return "not (" + match.to_string() + ")"; }
+
+    const any_matcher<T> match;
+};
+
+/**
+ * base class for logic matchers, any_of(), all_of().
+ */
+template <typename T>
+struct logical_matcher : matcher<T>
+{
+protected:
+    logical_matcher() { }
+
+    template <typename M, typename... Ms>
+    logical_matcher( M const & m, Ms const &... ms) : matchers()
+    {
+        combine( m, ms... );
+    }
+
+    template <typename U>
+    logical_matcher( std::initializer_list<U> const & list ) : matchers()
+    {
+        for ( auto const & x : list )
+        {
+            push_back( equal_to_matcher<T>( x ) );
+        }
+    }
+
+    explicit logical_matcher( std::vector<any_matcher<T>> const & matchers ) : matchers( matchers ) { }
+
+    bool any_of( T const & expected ) const
+    {
         return std::any_of(
-            cont.begin(), cont.end(),
-            [this]( typename C::value_type const & value ) { return (*match)(value); }
+            matchers.begin(), matchers.end(),
+            [&expected]( any_matcher<T> const & match ) { return match(expected); }
+        );
+    }
+
+    bool all_of( T const & expected ) const
+    {
+        return std::all_of(
+            matchers.begin(), matchers.end(),
+            [&expected]( any_matcher<T> const & match ) { return match(expected); }
         );
     }
 
-    std::string to_string() const { return "contains " +  match->to_string(); }
-    
-    Matcher<T> match;
+    std::string to_string_op( std::string op ) const
+    {
+        const std::string padded_op = " " + op + " ";
+
+        auto first = matchers.begin();
+        auto  last = matchers.end();
+
+        if ( first == last )
+            return "()";
+
+        std::string result = "(" + first->to_string();
+
+        ++first;
+        while (first != last)
+        {
+            result += padded_op + first->to_string();
+            ++first;
+        }
+
+        return result + ")";
+    }
+
+private:
+    void combine() {}
+
+    template <typename M, typename... Ms>
+    void combine( M const & m, Ms const &... ms)
+    {
+        push_back( m );
+        combine( ms... );
+    }
+
+    template <typename M>
+    void push_back( M const & m )
+    {
+        matchers.push_back( any_matcher<T>( m ) );
+    }
+
+    std::vector<any_matcher<T>> matchers;
 };
 
 /**
- * contains( sequence ).
+ * any_of( {...} ), any_of( matcher... ).
  */
 template <typename T>
-struct contains_sequence_matcher : public matcher<T>
+struct any_of_matcher : public logical_matcher<T>
 {
-    explicit contains_sequence_matcher( std::initializer_list<T> const & sequence ) : sequence( sequence ) { }
+    template <typename M, typename... Ms>
+    any_of_matcher( M const & m, Ms const &... ms ) : logical_matcher<T>( m, ms... ) { }
 
-    Matcher<T> copy() const { return Matcher<T>( new contains_sequence_matcher( *this ) ); }
+    any_of_matcher( std::initializer_list<T> const & list ) : logical_matcher<T>( list ) { }
+
+    explicit any_of_matcher( std::vector<any_matcher<T>> const & matchers ) : logical_matcher<T>( matchers ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new any_of_matcher( *this ) ); }
+
+    bool operator()( T const & actual ) const { return this->any_of( actual ); }
+
+    std::string to_string() const { return this->to_string_op( "or" ); }
+};
+
+/**
+ * all_of( {...} ), all_of( matcher... ).
+ */
+template <typename T>
+struct all_of_matcher : public logical_matcher<T>
+{
+    template <typename M, typename... Ms>
+    all_of_matcher( M const & m, Ms const &... ms ) : logical_matcher<T>( m, ms... ) { }
+
+    all_of_matcher( std::initializer_list<T> const & list ) : logical_matcher<T>( list ) { }
+
+    explicit all_of_matcher( std::vector<any_matcher<T>> const & matchers ) : logical_matcher<T>( matchers ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new all_of_matcher( *this ) ); }
+
+    bool operator()( T const & actual ) const { return this->all_of( actual ); }
+
+    std::string to_string() const { return this->to_string_op( "and" ); }
+};
+
+// value-composed matchers:
+
+template <typename A, typename T, typename R>
+using ForNonArgument = typename std::enable_if< ! std::is_convertible<A, T>::value || ( is_text<A>::value && ! std::is_same<A, T>::value ), R>::type;
+
+/**
+ * base class for value-composed logic matchers, all_of(), any_of().
+ * The matchers are held by value and evaluated inline, without heap
+ * allocation; copy() provides the type-erased Matcher<T>. Two or more
+ * textual matchers are fused to evaluate them in one pass over the text.
+ */
+template <typename T, typename... Ms>
+struct logical_expr : matcher<T>
+{
+    static const bool fused = sizeof...(Ms) > 1 && are_text_predicates<Ms...>::value;
+
+protected:
+    explicit logical_expr( Ms const &... ms ) : matchers( ms... ), texts( predicates::make( ms... ) ) { }
+
+    template <typename A>
+    bool any_of_actual( A const & actual ) const { return any_of_actual( actual, std::integral_constant<bool, fused && is_text<A>::value>() ); }
+
+    template <typename A>
+    bool all_of_actual( A const & actual ) const { return all_of_actual( actual, std::integral_constant<bool, fused && is_text<A>::value>() ); }
+
+    template <typename A>
+    bool any_of_actual( A const & actual, std::true_type  ) const { return texts.any_of( to_text_view( actual ) ); }
+
+    template <typename A>
+    bool any_of_actual( A const & actual, std::false_type ) const { return any_of<0>( actual ); }
+
+    template <typename A>
+    bool all_of_actual( A const & actual, std::true_type  ) const { return texts.all_of( to_text_view( actual ) ); }
+
+    template <typename A>
+    bool all_of_actual( A const & actual, std::false_type ) const { return all_of<0>( actual ); }
+
+    template <std::size_t I, typename A>
+    auto any_of( A const & ) const -> typename std::enable_if< (I == sizeof...(Ms)), bool>::type { return false; }
+
+    template <std::size_t I, typename A>
+    auto any_of( A const & actual ) const -> typename std::enable_if< (I < sizeof...(Ms)), bool>::type
+    {
+        return evaluate( std::get<I>( matchers ), actual ) || any_of<I + 1>( actual );
+    }
+
+    template <std::size_t I, typename A>
+    auto all_of( A const & ) const -> typename std::enable_if< (I == sizeof...(Ms)), bool>::type { return true; }
+
+    template <std::size_t I, typename A>
+    auto all_of( A const & actual ) const -> typename std::enable_if< (I < sizeof...(Ms)), bool>::type
+    {
+        return evaluate( std::get<I>( matchers ), actual ) && all_of<I + 1>( actual );
+    }
+
+    template <std::size_t I>
+    auto to_string_op( std::string const & ) const -> typename std::enable_if< (I == sizeof...(Ms)), std::string>::type { return ")"; }
+
+    template <std::size_t I>
+    auto to_string_op( std::string const & op ) const -> typename std::enable_if< (I < sizeof...(Ms)), std::string>::type
+    {
+        return ( I == 0 ? "(" : " " + op + " " ) + std::get<I>( matchers ).to_string() + to_string_op<I + 1>( op );
+    }
+
+private:
+    using predicates = typename std::conditional<fused, text_predicates, no_text_predicates>::type;
+
+    const std::tuple<Ms...> matchers;
+    const predicates texts;
+};
+
+template <typename T, typename... Ms>
+const bool logical_expr<T, Ms...>::fused;
+
+/**
+ * any_of( matcher... ), composed by value.
+ */
+template <typename T, typename... Ms>
+struct any_of_expr : logical_expr<T, Ms...>
+{
+    explicit any_of_expr( Ms const &... ms ) : logical_expr<T, Ms...>( ms... ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new any_of_expr( *this ) ); }
+
+    bool operator()( T const & actual ) const { return this->any_of_actual( actual ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForNonArgument<C, T, bool> { return this->any_of_actual( cont ); }
+
+    std::string to_string() const { return this->template to_string_op<0>( "or" ); }
+};
+
+/**
+ * all_of( matcher... ), composed by value.
+ */
+template <typename T, typename... Ms>
+struct all_of_expr : logical_expr<T, Ms...>
+{
+    explicit all_of_expr( Ms const &... ms ) : logical_expr<T, Ms...>( ms... ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new all_of_expr( *this ) ); }
+
+    bool operator()( T const & actual ) const { return this->all_of_actual( actual ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForNonArgument<C, T, bool> { return this->all_of_actual( cont ); }
+
+    std::string to_string() const { return this->template to_string_op<0>( "and" ); }
+};
+
+/**
+ * is( matcher ), is( value ), composed by value.
+ */
+template <typename T, typename M>
+struct is_expr : matcher<T>
+{
+    explicit is_expr( M const & match ) : match( match ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new is_expr( *this ) ); }
+
+    bool operator()( T const & actual ) const { return evaluate( match, actual ); }
 
     template <typename C>
-    bool operator()( C const & cont ) const
+    auto operator()( C const & cont ) const -> ForNonArgument<C, T, bool> { return evaluate( match, cont ); }
+
+    template <typename A, typename N = M>
+    auto describe_mismatch( A const & actual ) const -> decltype( std::string( std::declval<N const &>().describe_mismatch( actual ) ) ) { return match.describe_mismatch( actual ); }
+
+    std::string to_string() const { return match.to_string(); }
+
+    const M match;
+};
+
+/**
+ * is_not( matcher ), is_not( value ), composed by value.
+ */
+template <typename T, typename M>
+struct is_not_expr : matcher<T>
+{
+    explicit is_not_expr( M const & match ) : match( match ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new is_not_expr( *this ) ); }
+
+    bool operator()( T const & actual ) const { return ! evaluate( match, actual ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForNonArgument<C, T, bool> { return ! evaluate( match, cont ); }
+
+    std::string to_string() const { return "not (" + match.to_string() + ")"; }
+
+    const M match;
+};
+
+/**
+ * contains( matcher ), composed by value.
+ */
+template <typename T, typename M>
+struct contains_expr : matcher<T>
+{
+    explicit contains_expr( M const & match ) : match( match ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new contains_expr( *this ) ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool>
     {
-        return cont.end() != std::search( cont.begin(), cont.end(), sequence.begin(), sequence.end() );
+        for ( auto const & value : cont )
+        {
+            if ( evaluate( match, value ) )
+                return true;
+        }
+        return false;
     }
 
-    std::string to_string() const { return "contains " + lest::to_string( sequence ); }
+    std::string to_string() const { return "contains " + match.to_string(); }
 
-    const std::initializer_list<T> sequence;
+    const M match;
 };
 
 /**
- * contains_elements( list ).
+ * size_is( matcher ), size_is( value ), composed by value.
  */
-template <typename T>
-struct contains_elements_matcher : public matcher<T>
+template <typename T, typename M>
+struct size_is_expr : matcher<T>
 {
-    explicit contains_elements_matcher( std::initializer_list<T> const & list ) : list( list ) { }
+    explicit size_is_expr( M const & match ) : match( match ) { }
 
-    Matcher<T> copy() const { return Matcher<T>( new contains_elements_matcher( *this ) ); }
+    Matcher<T> copy() const { return Matcher<T>( new size_is_expr( *this ) ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool> { return evaluate( match, cont.size() ); }
+
+    std::string to_string() const { return "size " + match.to_string(); }
 
+    const M match;
+};
+
+/**
+ * is_partitioned_by( matcher ): all elements that satisfy the matcher
+ * precede those that do not; composed by value.
+ */
+template <typename T, typename M>
+struct is_partitioned_by_expr : matcher<T>
+{
+    explicit is_partitioned_by_expr( M const & match ) : match( match ) { }
+
+    Matcher<T> copy() const { return Matcher<T>( new is_partitioned_by_expr( *this ) ); }
+
+    template <typename C>
+    auto operator()( C const & cont ) const -> ForContainer<C, bool> { return violation( cont ) == no_violation; }
+
+    template <typename C>
+    auto describe_mismatch( C const & cont ) const -> ForContainer<C, std::string> { return describe_violation( cont, violation( cont ) ); }
+
+    std::string to_string() const { return "is partitioned by " + match.to_string(); }
+
+    const M match;
+
+private:
     template <typename C>
-    bool operator()( C const & cont ) const
+    std::size_t violation( C const & cont ) const
     {
-#if 1
-        return ! std::any_of( begin(list), end(list)
-            , [&cont]( typename C::value_type const & value ) { return 0 == std::count( begin(cont), end(cont), value ); } );
-#else
-        for ( auto const & element : list )
+        bool partitioned = false;
+        std::size_t i = 0;
+
+        for ( auto pos = std::begin( cont ); pos != std::end( cont ); ++pos, ++i )
         {
-            if ( 0 == std::count( begin(cont), end(cont), element ) )
-                return false;
+            const bool satisfied = evaluate( match, *pos );
+
+            if ( satisfied && partitioned )
+                return i;
+
+            partitioned = partitioned || ! satisfied;
         }
-        return true;
-#endif
+        return no_violation;
     }
+};
+
+/**
+ * dictionary: container of key-value pairs. Lookup visits the entries with
+ * a key via the dictionary's own equal_range() if it has one, such as
+ * std::map, std::multimap and std::unordered_map, else via a linear scan,
+ * e.g. for a std::vector of std::pair. Entries are passed by reference.
+ */
+template <typename D, typename = void>
+struct is_dictionary : std::false_type { };
+
+template <typename D>
+struct is_dictionary< D, decltype( void( std::declval<D const &>().begin()->first ), void( std::declval<D const &>().begin()->second ) ) > : std::true_type { };
+
+template <typename D, typename R>
+using ForDictionary = typename std::enable_if< is_dictionary<D>::value, R>::type;
+
+template <typename D, typename K, typename = void>
+struct has_member_equal_range : std::false_type { };
+
+template <typename D, typename K>
+struct has_member_equal_range< D, K, decltype( void( std::declval<D const &>().equal_range( std::declval<K const &>() ).first == std::declval<D const &>().end() ) ) > : std::true_type { };
+
+template <typename D, typename = void>
+struct has_member_key_comp : std::false_type { };
+
+template <typename D>
+struct has_member_key_comp< D, decltype( void( std::declval<D const &>().key_comp() ) ) > : std::true_type { };
+
+template <typename D, typename K, typename F>
+inline bool any_entry_with_key( D const & dict, K const & key, F pred, std::true_type )
+{
+    const auto range = dict.equal_range( key );
+    return std::any_of( range.first, range.second, pred );
+}
 
-    std::string to_string() const { return "contains elements " + lest::to_string( list ); }
+template <typename D, typename K, typename F>
+inline bool any_entry_with_key( D const & dict, K const & key, F pred, std::false_type )
+{
+    for ( auto const & entry : dict )
+    {
+        if ( entry.first == key && pred( entry ) )
+            return true;
+    }
+    return false;
+}
 
-    const std::initializer_list<T> list;
-};
+template <typename D, typename K, typename F>
+inline bool any_entry_with_key( D const & dict, K const & key, F pred )
+{
+    return any_entry_with_key( dict, key, pred, has_member_equal_range<D, K>() );
+}
 
 /**
- * is_empty().
+ * has_key( key ): lookup via equal_range() where available.
  */
-struct is_empty_matcher : matcher<int>
+template <typename K>
+struct has_key_matcher : matcher<K>
 {
-    explicit is_empty_matcher() { }
+    explicit has_key_matcher( K const & key ) : key( key ) { }
 
-    Matcher<int> copy() const { return Matcher<int>( new is_empty_matcher() ); }
+    Matcher<K> copy() const { return Matcher<K>( new has_key_matcher( *this ) ); }
 
-    template <typename C>
-    bool operator()( C const & cont ) const { return cont.empty(); }
+    template <typename D>
+    auto operator()( D const & dict ) const -> ForDictionary<D, bool>
+    {
+        return any_entry_with_key( dict, key, []( typename D::value_type const & ) { return true; } );
+    }
 
-    std::string to_string() const { return "is empty "; }
+    std::string to_string() const { return "has key " + lest::to_string( key ); }
+
+    const K key;
 };
 
 /**
- * size_is().
+ * has_key( matcher ), composed by value.
  */
-template <typename T>
-struct size_is_matcher : matcher<T>
+template <typename K, typename M>
+struct has_key_expr : matcher<K>
 {
-    size_is_matcher( T const & size ) : match( equal_to_matcher<T>( size ).copy() ) { }
+    explicit has_key_expr( M const & match ) : match( match ) { }
 
-    explicit size_is_matcher( matcher<T> const & match ) : match( match.copy() ) { }
+    Matcher<K> copy() const { return Matcher<K>( new has_key_expr( *this ) ); }
 
-    Matcher<T> copy() const { return Matcher<T>( new size_is_matcher( *this)  ); }
+    template <typename D>
+    auto operator()( D const & dict ) const -> ForDictionary<D, bool>
+    {
+        for ( auto const & entry : dict )
+        {
+            if ( evaluate( match, entry.first ) )
+                return true;
+        }
+        return false;
+    }
 
-    template <typename C>
-    bool operator()( C const & cont ) const { return (*match)( cont.size() ); }
+    std::string to_string() const { return "has key " + match.to_string(); }
 
-    std::string to_string() const { return "size " +  match->to_string(); }
-    
-    Matcher<T> match;
+    const M match;
 };
 
 /**
- * anything( [description] ): match anything of type T.
+ * has_value( matcher ), has_value( value ), composed by value.
  */
-template <typename T>
-struct anything : matcher<T>
+template <typename V, typename M>
+struct has_value_expr : matcher<V>
 {
-    explicit anything( std::string description = "[anything]" ) : description( description ) { }
+    explicit has_value_expr( M const & match ) : match( match ) { }
 
-    Matcher<T> copy() const { return Matcher<T>( new anything(*this) ); }
+    Matcher<V> copy() const { return Matcher<V>( new has_value_expr( *this ) ); }
 
-    bool operator()( T const & /*actual*/ ) const { return true; }
+    template <typename D>
+    auto operator()( D const & dict ) const -> ForDictionary<D, bool>
+    {
+        for ( auto const & entry : dict )
+        {
+            if ( evaluate( match, entry.second ) )
+                return true;
+        }
+        return false;
+    }
 
-    std::string to_string() const { return lest::to_string( description ); }
+    std::string to_string() const { return "has value " + match.to_string(); }
 
-    const std::string description;
+    const M match;
 };
 
 /**
- * is( matcher ), is( value )
+ * has_entry( key, matcher ), has_entry( key, value ): lookup of the key via
+ * equal_range() where available, the value matcher is applied in place.
  */
-template <typename T>
-struct is_matcher : matcher<T>
+template <typename K, typename M>
+struct has_entry_matcher : matcher<K>
 {
-    is_matcher( T value ) : match( equal_to_matcher<T>( value ).copy() ) { }
-
-    explicit is_matcher( matcher<T> const & match ) : match( match.copy() ) { }
+    has_entry_matcher( K const & key, M const & match ) : key( key ), match( match ) { }
 
-    Matcher<T> copy() const { return match; }
+    Matcher<K> copy() const { return Matcher<K>( new has_entry_matcher( *this ) ); }
 
-    bool operator()( T const & actual ) const { return (*match)( actual ); }
+    template <typename D>
+    auto operator()( D const & dict ) const -> ForDictionary<D, bool>
+    {
+        return any_entry_with_key( dict, key, [this]( typename D::value_type const & entry ) { return evaluate( match, entry.second ); } );
+    }
 
-    std::string to_string() const { return match->to_string(); }
+    std::string to_string() const { return "has entry " + lest::to_string( key ) + ": " + match.to_string(); }
 
-    const Matcher<T> match;
+    const K key;
+    const M match;
 };
 
 /**
- * is_not( matcher ), is_not( value )
+ * has_entry( key matcher, value matcher ), composed by value.
  */
-template <typename T>
-struct is_not_matcher : matcher<T>
+template <typename K, typename KM, typename VM>
+struct has_entry_expr : matcher<K>
 {
-    is_not_matcher( T value ) : match( equal_to_matcher<T>( value ).copy() ) { }
-
-    explicit is_not_matcher( matcher<T> const & match ) : match( match.copy() ) { }
+    has_entry_expr( KM const & key_match, VM const & value_match ) : key_match( key_match ), value_match( value_match ) { }
 
-    Matcher<T> copy() const { return match; }
+    Matcher<K> copy() const { return Matcher<K>( new has_entry_expr( *this ) ); }
 
-    bool operator()( T const & actual ) const { return ! (*match)( actual ); }
+    template <typename D>
+    auto operator()( D const & dict ) const -> ForDictionary<D, bool>
+    {
+        for ( auto const & entry : dict )
+        {
+            if ( evaluate( key_match, entry.first ) && evaluate( value_match, entry.second ) )
+                return true;
+        }
+        return false;
+    }
 
-    std::string to_string() const { return "not (" + match->to_string() + ")"; }
+    std::string to_string() const { return "has entry " + key_match.to_string() + ": " + value_match.to_string(); }
 
-    const Matcher<T> match;
+    const KM key_match;
+    const VM value_match;
 };
 
 /**
- * base class for logic matchers, any_of(), all_of().
+ * has_entries( {{key, value}...} ): a few entries are looked up one by one,
+ * many entries in an ordered dictionary via a single merge walk over the
+ * dictionary in key order.
  */
-template <typename T>
-struct logical_matcher : matcher<T>
+template <typename K, typename V>
+struct has_entries_matcher : matcher<K>
 {
-protected:
-    logical_matcher() { }
+    explicit has_entries_matcher( std::vector<std::pair<K, V>> const & entries ) : entries( entries ) { }
 
-    template <typename M, typename... Ms>
-    logical_matcher( M const & m, Ms const &... ms) : matchers()
-    {
-        combine( m, ms... );
-    }
+    Matcher<K> copy() const { return Matcher<K>( new has_entries_matcher( *this ) ); }
 
-    template <typename U>
-    logical_matcher( std::initializer_list<U> const & list ) : matchers()
-    {
-        for ( auto const & x : list )
-        {
-            push_back( equal_to_matcher<T>( x ) );
-        }
-    }
+    template <typename D>
+    auto operator()( D const & dict ) const -> ForDictionary<D, bool> { return missing( dict, false ).empty(); }
 
-    bool any_of( T const & expected ) const
+    template <typename D>
+    auto describe_mismatch( D const & dict ) const -> ForDictionary<D, std::string>
     {
-        return std::any_of(
-            matchers.begin(), matchers.end(),
-            [expected]( Matcher<T> match ) { return (*match)(expected); }
-        );
+        const std::vector<std::pair<K, V>> absent = missing( dict, true );
+        return absent.empty() ? "" : "missing " + lest::to_string( absent );
     }
 
-    bool all_of( T const & expected ) const
-    {
-        return std::all_of(
-            matchers.begin(), matchers.end(),
-            [expected]( Matcher<T> match ) { return (*match)(expected); }
-        );
-    }
+    std::string to_string() const { return "has entries " + lest::to_string( entries ); }
 
-    std::string to_string_op( std::string op ) const
-    {
-        const std::string padded_op = " " + op + " ";
+    const std::vector<std::pair<K, V>> entries;
 
-        auto first = matchers.begin();
-        auto  last = matchers.end();
+private:
+    /// the expected entries that dict lacks; only the first one unless all.
+    template <typename D>
+    std::vector<std::pair<K, V>> missing( D const & dict, bool all ) const
+    {
+        std::vector<bool> found( entries.size(), false );
 
-        std::string result = "(" + (*first)->to_string();
+        find( dict, found, all, has_member_key_comp<D>() );
 
-        ++first;
-        while (first != last)
+        std::vector<std::pair<K, V>> result;
+        for ( std::size_t i = 0; i < entries.size() && ( all || result.empty() ); ++i )
         {
-            result += padded_op + (*first)->to_string();
-            ++first;
+            if ( ! found[i] )
+                result.push_back( entries[i] );
         }
-
-        return result + ")";
+        return result;
     }
 
-private:
-    void combine() {}
-
-    template <typename M, typename... Ms>
-    void combine( M const & m, Ms const &... ms)
+    template <typename D>
+    void find( D const & dict, std::vector<bool> & found, bool all, std::false_type ) const
     {
-        push_back( m );
-        combine( ms... );
-    }
+        for ( std::size_t i = 0; i < entries.size(); ++i )
+        {
+            V const & value = entries[i].second;
 
-    template <typename M>
-    void push_back( M const & m )
-    {
-        matchers.push_back( m.copy() );
+            if ( ! ( found[i] = any_entry_with_key( dict, entries[i].first, [&value]( typename D::value_type const & entry ) { return entry.second == value; } ) ) && ! all )
+                return;
+        }
     }
 
-    std::vector<Matcher<T>> matchers;
-};
+    // ordered dictionary: merge walk if it beats a lookup per entry:
 
-/**
- * any_of( {...} ), any_of( matcher... ).
- */
-template <typename T>
-struct any_of_matcher : public logical_matcher<T>
-{
-    template <typename M, typename... Ms>
-    any_of_matcher( M const & m, Ms const &... ms ) : logical_matcher<T>( m, ms... ) { }
+    template <typename D>
+    void find( D const & dict, std::vector<bool> & found, bool all, std::true_type ) const
+    {
+        const double n = static_cast<double>( dict.size() );
 
-    any_of_matcher( std::initializer_list<T> const & list ) : logical_matcher<T>( list ) { }
+        if ( static_cast<double>( entries.size() ) * std::log2( n + 1 ) < n )
+            return find( dict, found, all, std::false_type() );
 
-    Matcher<T> copy() const { return Matcher<T>( new any_of_matcher( *this ) ); }
+        const auto less = dict.key_comp();
 
-    bool operator()( T const & actual ) const { return this->any_of( actual ); }
+        std::vector<std::size_t> order( entries.size() );
+        for ( std::size_t i = 0; i < order.size(); ++i )
+            order[i] = i;
 
-    std::string to_string() const { return this->to_string_op( "or" ); }
-};
+        std::stable_sort( order.begin(), order.end(), [&]( std::size_t a, std::size_t b ) { return less( entries[a].first, entries[b].first ); } );
 
-/**
- * all_of( {...} ), all_of( matcher... ).
- */
-template <typename T>
-struct all_of_matcher : public logical_matcher<T>
-{
-    template <typename M, typename... Ms>
-    all_of_matcher( M const & m, Ms const &... ms ) : logical_matcher<T>( m, ms... ) { }
+        auto pos = dict.begin();
 
-    all_of_matcher( std::initializer_list<T> const & list ) : logical_matcher<T>( list ) { }
+        for ( auto i : order )
+        {
+            K const & key = entries[i].first;
 
-    Matcher<T> copy() const { return Matcher<T>( new all_of_matcher( *this ) ); }
+            while ( pos != dict.end() && less( pos->first, key ) )
+                ++pos;
 
-    bool operator()( T const & actual ) const { return this->all_of( actual ); }
+            for ( auto at = pos; at != dict.end() && ! less( key, at->first ) && ! found[i]; ++at )
+                found[i] = at->second == entries[i].second;
 
-    std::string to_string() const { return this->to_string_op( "and" ); }
+            if ( ! found[i] && ! all )
+                return;
+        }
+    }
 };
 
-LEST_TAG_MATCHER( close_to_matcher );
-LEST_TAG_MATCHER( anything );
-LEST_TAG_MATCHER( same_instance_matcher );
-LEST_TAG_MATCHER( is_matcher );
-LEST_TAG_MATCHER( is_not_matcher );
-LEST_TAG_MATCHER( any_of_matcher );
-LEST_TAG_MATCHER( all_of_matcher );
-
 // distinguish between matchers and values:
 
 template <typename T, typename R>
@@ -676,20 +2764,40 @@ inline contains_string_matcher contains( const char * text )
     return contains_string_matcher( text );
 }
 
-inline auto contains_regexp( std::string const & expr ) -> contains_regexp_matcher 
+inline auto contains_any_of( std::vector<std::string> const & texts ) -> contains_any_of_matcher
+{
+    return contains_any_of_matcher( texts );
+}
+
+inline auto contains_all_of( std::vector<std::string> const & texts ) -> contains_all_of_matcher
+{
+    return contains_all_of_matcher( texts );
+}
+
+inline auto contains_regexp( std::string const & expr, std::regex::flag_type flags = std::regex::ECMAScript, regex_engine engine = default_regex_engine ) -> contains_regexp_matcher
+{
+    return contains_regexp_matcher( expr, flags, engine );
+}
+
+inline auto contains_regexp( std::string const & expr, regex_engine engine ) -> contains_regexp_matcher
+{
+    return contains_regexp_matcher( expr, std::regex::ECMAScript, engine );
+}
+
+inline auto matches_regexp( std::string const & expr, std::regex::flag_type flags = std::regex::ECMAScript, regex_engine engine = default_regex_engine ) -> match_regexp_matcher
 {
-    return contains_regexp_matcher( expr );
+    return match_regexp_matcher( expr, flags, engine );
 }
 
-inline auto matches_regexp( std::string const & expr ) -> match_regexp_matcher 
+inline auto matches_regexp( std::string const & expr, regex_engine engine ) -> match_regexp_matcher
 {
-    return match_regexp_matcher( expr );
+    return match_regexp_matcher( expr, std::regex::ECMAScript, engine );
 }
 
 template <typename T>
-inline auto contains( T const & element ) -> ForMatcher<T, contains_matcher<typename T::argument_type>>
+inline auto contains( T const & element ) -> ForMatcher<T, contains_expr<typename T::argument_type, T>>
 {
-    return contains_matcher<typename T::argument_type>( element );
+    return contains_expr<typename T::argument_type, T>( element );
 }
 
 template <typename T>
@@ -704,76 +2812,255 @@ inline auto contains( std::initializer_list<T> const & list ) -> contains_sequen
     return contains_sequence_matcher<T>( list );
 }
 
+template <typename T>
+inline auto contains( std::vector<T> const & sequence ) -> contains_sequence_matcher<T>
+{
+    return contains_sequence_matcher<T>( sequence );
+}
+
 template <typename T>
 inline auto contains_elements( std::initializer_list<T> const & list ) -> contains_elements_matcher<T> 
 {
     return contains_elements_matcher<T>( list );
 }
 
+template <typename T>
+inline auto contains_elements( std::vector<T> const & list ) -> contains_elements_matcher<T>
+{
+    return contains_elements_matcher<T>( list );
+}
+
+template <typename T>
+inline auto contains_in_any_order( std::initializer_list<T> const & list ) -> contains_in_any_order_matcher<T>
+{
+    return contains_in_any_order_matcher<T>( list, "contains in any order" );
+}
+
+template <typename T>
+inline auto contains_in_any_order( std::vector<T> const & list ) -> contains_in_any_order_matcher<T>
+{
+    return contains_in_any_order_matcher<T>( list, "contains in any order" );
+}
+
+template <typename C>
+inline auto is_permutation_of( C const & cont ) -> ForContainer<C, contains_in_any_order_matcher<element_of<C>>>
+{
+    return contains_in_any_order_matcher<element_of<C>>( std::vector<element_of<C>>( std::begin( cont ), std::end( cont ) ), "is permutation of" );
+}
+
+template <typename C>
+inline auto unordered_equal_to( C const & cont ) -> ForContainer<C, contains_in_any_order_matcher<element_of<C>>>
+{
+    return contains_in_any_order_matcher<element_of<C>>( std::vector<element_of<C>>( std::begin( cont ), std::end( cont ) ), "unordered equal to" );
+}
+
+// dictionary keys and values given as text are held as std::string:
+
+template <typename T>
+using dictionary_type = typename std::conditional<
+    std::is_convertible<typename std::decay<T>::type, char const *>::value, std::string, typename std::decay<T>::type >::type;
+
+template <typename K>
+inline has_key_matcher<dictionary_type<K>> has_key_implementation( K const & key, not_matcher_tag )
+{
+    return has_key_matcher<dictionary_type<K>>( key );
+}
+
+template <typename M>
+inline has_key_expr<typename M::argument_type, M> has_key_implementation( M const & match, matcher_tag )
+{
+    return has_key_expr<typename M::argument_type, M>( match );
+}
+
+template <typename K>
+inline auto has_key( K const & key ) -> decltype( has_key_implementation( key, typename matcher_traits<K>::category() ) )
+{
+    return has_key_implementation( key, typename matcher_traits<K>::category() );
+}
+
+template <typename V>
+inline has_value_expr<dictionary_type<V>, equal_to_matcher<dictionary_type<V>>> has_value_implementation( V const & value, not_matcher_tag )
+{
+    return has_value_expr<dictionary_type<V>, equal_to_matcher<dictionary_type<V>>>( equal_to_matcher<dictionary_type<V>>( value ) );
+}
+
+template <typename M>
+inline has_value_expr<typename M::argument_type, M> has_value_implementation( M const & match, matcher_tag )
+{
+    return has_value_expr<typename M::argument_type, M>( match );
+}
+
+template <typename V>
+inline auto has_value( V const & value ) -> decltype( has_value_implementation( value, typename matcher_traits<V>::category() ) )
+{
+    return has_value_implementation( value, typename matcher_traits<V>::category() );
+}
+
+template <typename K, typename V>
+inline has_entry_matcher<dictionary_type<K>, equal_to_matcher<dictionary_type<V>>> has_entry_implementation( K const & key, V const & value, not_matcher_tag, not_matcher_tag )
+{
+    return has_entry_matcher<dictionary_type<K>, equal_to_matcher<dictionary_type<V>>>( key, equal_to_matcher<dictionary_type<V>>( value ) );
+}
+
+template <typename K, typename M>
+inline has_entry_matcher<dictionary_type<K>, M> has_entry_implementation( K const & key, M const & match, not_matcher_tag, matcher_tag )
+{
+    return has_entry_matcher<dictionary_type<K>, M>( key, match );
+}
+
+template <typename KM, typename V>
+inline has_entry_expr<typename KM::argument_type, KM, equal_to_matcher<dictionary_type<V>>> has_entry_implementation( KM const & key_match, V const & value, matcher_tag, not_matcher_tag )
+{
+    return has_entry_expr<typename KM::argument_type, KM, equal_to_matcher<dictionary_type<V>>>( key_match, equal_to_matcher<dictionary_type<V>>( value ) );
+}
+
+template <typename KM, typename VM>
+inline has_entry_expr<typename KM::argument_type, KM, VM> has_entry_implementation( KM const & key_match, VM const & value_match, matcher_tag, matcher_tag )
+{
+    return has_entry_expr<typename KM::argument_type, KM, VM>( key_match, value_match );
+}
+
+template <typename K, typename V>
+inline auto has_entry( K const & key, V const & value )
+    -> decltype( has_entry_implementation( key, value, typename matcher_traits<K>::category(), typename matcher_traits<V>::category() ) )
+{
+    return has_entry_implementation( key, value, typename matcher_traits<K>::category(), typename matcher_traits<V>::category() );
+}
+
+template <typename K, typename V>
+inline auto has_entries( std::initializer_list<std::pair<K, V>> const & entries ) -> has_entries_matcher<dictionary_type<K>, dictionary_type<V>>
+{
+    return has_entries_matcher<dictionary_type<K>, dictionary_type<V>>( std::vector<std::pair<dictionary_type<K>, dictionary_type<V>>>( entries.begin(), entries.end() ) );
+}
+
+template <typename D>
+inline auto has_entries( D const & entries ) -> ForDictionary<D, has_entries_matcher<typename std::decay<decltype( entries.begin()->first )>::type, typename std::decay<decltype( entries.begin()->second )>::type>>
+{
+    using K = typename std::decay<decltype( entries.begin()->first )>::type;
+    using V = typename std::decay<decltype( entries.begin()->second )>::type;
+
+    return has_entries_matcher<K, V>( std::vector<std::pair<K, V>>( entries.begin(), entries.end() ) );
+}
+
+template <typename C>
+inline auto sorted( C const & cont ) -> sorted_range<typename C::const_iterator>
+{
+    return sorted_range<typename C::const_iterator>( cont.begin(), cont.end(), less() );
+}
+
+template <typename C, typename L>
+inline auto sorted( C const & cont, L less ) -> sorted_range<typename C::const_iterator, L>
+{
+    return sorted_range<typename C::const_iterator, L>( cont.begin(), cont.end(), less );
+}
+
+inline auto is_sorted() -> is_sorted_matcher<>
+{
+    return is_sorted_matcher<>( less(), false );
+}
+
+template <typename L>
+inline auto is_sorted( L order ) -> is_sorted_matcher<L>
+{
+    return is_sorted_matcher<L>( order, false );
+}
+
+inline auto is_strictly_increasing() -> is_sorted_matcher<>
+{
+    return is_sorted_matcher<>( less(), true );
+}
+
+template <typename L>
+inline auto is_strictly_increasing( L order ) -> is_sorted_matcher<L>
+{
+    return is_sorted_matcher<L>( order, true );
+}
+
+inline auto has_unique_elements() -> has_unique_elements_matcher
+{
+    return has_unique_elements_matcher();
+}
+
+inline auto is_heap() -> is_heap_matcher<>
+{
+    return is_heap_matcher<>( less() );
+}
+
+template <typename L>
+inline auto is_heap( L order ) -> is_heap_matcher<L>
+{
+    return is_heap_matcher<L>( order );
+}
+
+template <typename M>
+inline auto is_partitioned_by( M const & match ) -> ForMatcher<M, is_partitioned_by_expr<typename M::argument_type, M>>
+{
+    return is_partitioned_by_expr<typename M::argument_type, M>( match );
+}
+
 inline auto is_empty() -> is_empty_matcher 
 {
     return is_empty_matcher();
 }
 
 template <typename T>
-inline auto size_is( T const & match ) -> ForValue<T, size_is_matcher<std::size_t>>
+inline auto size_is( T const & match ) -> ForValue<T, size_is_expr<std::size_t, equal_to_matcher<std::size_t>>>
 {
-    return size_is_matcher<std::size_t>( match );
+    return size_is_expr<std::size_t, equal_to_matcher<std::size_t>>( equal_to_matcher<std::size_t>( match ) );
 }
 
 template <typename M>
-inline auto size_is( M const & match ) -> ForMatcher<M, size_is_matcher<typename M::value_type>>
+inline auto size_is( M const & match ) -> ForMatcher<M, size_is_expr<typename M::value_type, M>>
 {
-    return size_is_matcher<typename M::value_type>( match );
+    return size_is_expr<typename M::value_type, M>( match );
 }
 
 template <typename T>
-inline is_matcher<typename T::argument_type> is_implementation( T const & expected, matcher_tag )
+inline is_expr<typename T::argument_type, T> is_implementation( T const & expected, matcher_tag )
 {
-    return is_matcher<typename T::argument_type>( expected );
+    return is_expr<typename T::argument_type, T>( expected );
 }
 
 template <typename T>
-inline is_matcher<T> is_implementation( T const & expected, not_matcher_tag )
+inline is_expr<T, equal_to_matcher<T>> is_implementation( T const & expected, not_matcher_tag )
 {
-    return is_matcher<T>( expected );
+    return is_expr<T, equal_to_matcher<T>>( equal_to_matcher<T>( expected ) );
 }
 
 template <typename T>
-inline is_matcher<typename matcher_traits<T>::argument> is( T const & expected )
+inline auto is( T const & expected ) -> decltype( is_implementation( expected, typename matcher_traits<T>::category() ) )
 {
     return is_implementation( expected, typename matcher_traits<T>::category() );
 }
 
 template <typename T>
-inline is_matcher<const T*> is( const T expected[] )
+inline is_expr<const T*, equal_to_matcher<const T*>> is( const T expected[] )
 {
-    return is_implementation( expected, not_matcher_tag() );
+    return is_implementation<const T*>( expected, not_matcher_tag() );
 }
 
 template <typename T>
-inline is_not_matcher<typename T::argument_type> is_not_implementation( T const & expected, matcher_tag )
+inline is_not_expr<typename T::argument_type, T> is_not_implementation( T const & expected, matcher_tag )
 {
-    return is_not_matcher<typename T::argument_type>( expected );
+    return is_not_expr<typename T::argument_type, T>( expected );
 }
 
 template <typename T>
-inline is_not_matcher<T> is_not_implementation( T const & expected, not_matcher_tag )
+inline is_not_expr<T, equal_to_matcher<T>> is_not_implementation( T const & expected, not_matcher_tag )
 {
-    return is_not_matcher<T>( expected );
-//    return is_not_matcher<T>( equal_to( expected ) );
+    return is_not_expr<T, equal_to_matcher<T>>( equal_to_matcher<T>( expected ) );
 }
 
 template <typename T>
-inline is_not_matcher<typename matcher_traits<T>::argument> is_not( T const & expected )
+inline auto is_not( T const & expected ) -> decltype( is_not_implementation( expected, typename matcher_traits<T>::category() ) )
 {
     return is_not_implementation( expected, typename matcher_traits<T>::category() );
 }
 
 template <typename T>
-inline is_not_matcher<const T*> is_not( const T expected[] )
+inline is_not_expr<const T*, equal_to_matcher<const T*>> is_not( const T expected[] )
 {
-    return is_not_implementation( expected, not_matcher_tag() );
+    return is_not_implementation<const T*>( expected, not_matcher_tag() );
 }
 
 template <typename T>
@@ -782,10 +3069,16 @@ inline any_of_matcher<T> any_of( std::initializer_list<T> const & list )
     return any_of_matcher<T>( list );
 }
 
+template <typename T>
+inline any_of_matcher<T> any_of( std::vector<any_matcher<T>> const & matchers )
+{
+    return any_of_matcher<T>( matchers );
+}
+
 template <typename M, typename... Ms>
-inline any_of_matcher<typename M::argument_type> any_of( M const & m, Ms const &... ms )
+inline any_of_expr<typename M::argument_type, M, Ms...> any_of( M const & m, Ms const &... ms )
 {
-    return any_of_matcher<typename M::argument_type>( m, ms... );
+    return any_of_expr<typename M::argument_type, M, Ms...>( m, ms... );
 }
 
 template <typename T>
@@ -794,10 +3087,16 @@ inline all_of_matcher<T> all_of( std::initializer_list<T> const & list )
     return all_of_matcher<T>( list );
 }
 
+template <typename T>
+inline all_of_matcher<T> all_of( std::vector<any_matcher<T>> const & matchers )
+{
+    return all_of_matcher<T>( matchers );
+}
+
 template <typename M, typename... Ms>
-inline all_of_matcher<typename M::argument_type> all_of( M const & m, Ms const &... ms )
+inline all_of_expr<typename M::argument_type, M, Ms...> all_of( M const & m, Ms const &... ms )
 {
-    return all_of_matcher<typename M::argument_type>( m, ms... );
+    return all_of_expr<typename M::argument_type, M, Ms...>( m, ms... );
 }
 
 namespace hamlest {
@@ -824,22 +3123,34 @@ using lest::greater_equal;
 using lest::starts_with;
 using lest::ends_with;
 using lest::contains;
+using lest::contains_any_of;
+using lest::contains_all_of;
 using lest::contains_regexp;    // fails with g++ 4.8.1
 using lest::matches_regexp;
+using lest::regex_engine;
 
 // sequence:
 
 //using lest::contains;         // already declared
 using lest::contains_elements;
+using lest::contains_in_any_order;
+using lest::is_permutation_of;
+using lest::unordered_equal_to;
+using lest::sorted;
 using lest::is_empty;
+using lest::is_sorted;
+using lest::is_strictly_increasing;
+using lest::has_unique_elements;
+using lest::is_heap;
+using lest::is_partitioned_by;
 using lest::size_is;
 
 // dictionary:
 
-//using lest::has_entries;
-//using lest::has_entry;
-//using lest::has_key;
-//using lest::has_value;
+using lest::has_entries;
+using lest::has_entry;
+using lest::has_key;
+using lest::has_value;
 
 // logical:
 
@@ -854,11 +3165,12 @@ using lest::is_not;
 using lest::all_of;
 using lest::any_of;
 
+using lest::any_matcher;
+
 } // namespace match
 
 } // namespace lest
 
-#undef LEST_TAG_MATCHER
 #undef LEST_COMPARISON_MATCHER
 
 #endif // LEST_HAMLEST_H_INCLUDED
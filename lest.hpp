@@ -10,17 +10,24 @@
 #define LEST_LEST_HPP_INCLUDED
 
 #include <algorithm>
+#include <bitset>
 #include <chrono>
+#include <exception>
+#include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <set>
+#include <thread>
 #include <tuple>
 #include <typeinfo>
 #include <type_traits>
@@ -30,6 +37,9 @@
 #include <cctype>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 
 #define lest_MAJOR  1
 #define lest_MINOR  35
@@ -53,10 +63,46 @@
 # define lest_FEATURE_REGEX_SEARCH  0
 #endif
 
+#ifndef  lest_FEATURE_LINEAR_REGEX
+# define lest_FEATURE_LINEAR_REGEX  0
+#endif
+
+#ifndef  lest_FEATURE_SIMD_SEARCH
+# if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#  define lest_FEATURE_SIMD_SEARCH  1
+# else
+#  define lest_FEATURE_SIMD_SEARCH  0
+# endif
+#endif
+
 #ifndef  lest_FEATURE_TIME_PRECISION
 # define lest_FEATURE_TIME_PRECISION  0
 #endif
 
+#ifndef  lest_FEATURE_MAX_ELEMENTS
+# define lest_FEATURE_MAX_ELEMENTS  100
+#endif
+
+#ifndef  lest_FEATURE_MAX_DEPTH
+# define lest_FEATURE_MAX_DEPTH  4
+#endif
+
+#ifndef  lest_FEATURE_FORK
+# if defined(__unix__) || defined(__APPLE__)
+#  define lest_FEATURE_FORK  1
+# else
+#  define lest_FEATURE_FORK  0
+# endif
+#endif
+
+#ifndef  lest_FEATURE_COORDINATOR
+# define lest_FEATURE_COORDINATOR  lest_FEATURE_FORK
+#endif
+
+#ifndef  lest_FEATURE_JOBS
+# define lest_FEATURE_JOBS  0
+#endif
+
 #ifndef  lest_FEATURE_WSTRING
 # define lest_FEATURE_WSTRING  1
 #endif
@@ -75,6 +121,40 @@
 # include <regex>
 #endif
 
+#if lest_FEATURE_JOBS
+# include <atomic>
+# include <condition_variable>
+#endif
+
+#if lest_FEATURE_FORK || lest_FEATURE_COORDINATOR
+# include <csignal>
+# include <poll.h>
+# include <unistd.h>
+#endif
+
+#if lest_FEATURE_FORK
+# include <sys/wait.h>
+#endif
+
+#if lest_FEATURE_COORDINATOR
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/un.h>
+#endif
+
+#if lest_FEATURE_SIMD_SEARCH
+# include <emmintrin.h>
+# if ( defined(__GNUC__) || defined(__clang__) ) && ( defined(__x86_64__) || defined(__i386__) )
+#  include <immintrin.h>
+#  define lest_HAVE_AVX2_DISPATCH  1
+# else
+#  define lest_HAVE_AVX2_DISPATCH  0
+# endif
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+#endif
+
 // Stringify:
 
 #define lest_STRINGIFY(  x )  lest_STRINGIFY_( x )
@@ -130,6 +210,20 @@
 #define lest_CPP17_OR_GREATER  ( lest_CPLUSPLUS >= 201703L )
 #define lest_CPP20_OR_GREATER  ( lest_CPLUSPLUS >= 202000L )
 
+// std::to_chars() with floating-point support for number formatting:
+
+#if lest_CPP17_OR_GREATER && defined( __has_include )
+# if __has_include( <charconv> )
+#  include <charconv>
+# endif
+#endif
+
+#if defined( __cpp_lib_to_chars ) && __cpp_lib_to_chars >= 201611L
+# define lest_HAVE_TO_CHARS  1
+#else
+# define lest_HAVE_TO_CHARS  0
+#endif
+
 #if ! defined( lest_NO_SHORT_MACRO_NAMES ) && ! defined( lest_NO_SHORT_ASSERTION_NAMES )
 # define MODULE            lest_MODULE
 
@@ -202,7 +296,7 @@
     do { \
         try \
         { \
-            if ( lest::result score = lest_DECOMPOSE( expr ) ) \
+            if ( lest::result score = lest_DECOMPOSE_IF( expr, lest_env.pass() && ! lest_env.zen(), true ) ) \
             { \
                 lest::report( lest_env.os, lest::failure{ lest_LOCATION, #expr, score.decomposition }, lest_env.context() ); \
                 throw lest::failure{ lest_LOCATION, #expr, score.decomposition }; \
@@ -220,7 +314,7 @@
     do { \
         try \
         { \
-            if ( lest::result score = lest_DECOMPOSE( expr ) ) \
+            if ( lest::result score = lest_DECOMPOSE_IF( expr, true, lest_env.pass() && ! lest_env.zen() ) ) \
             { \
                 if ( lest_env.pass() ) \
                     lest::report( lest_env.os, lest::passing{ lest_LOCATION, lest::not_expr( #expr ), lest::not_expr( score.decomposition ), lest_env.zen() }, lest_env.context() ); \
@@ -298,6 +392,7 @@
 #define lest_UNIQUE3( name, line ) name ## line
 
 #define lest_DECOMPOSE( expr ) ( lest::expression_decomposer() << expr )
+#define lest_DECOMPOSE_IF( expr, describe_true, describe_false ) ( lest::expression_decomposer( describe_true, describe_false ) << expr )
 
 #define lest_FUNCTION  lest_UNIQUE(__lest_function__  )
 #define lest_REGISTRAR lest_UNIQUE(__lest_registrar__ )
@@ -537,6 +632,22 @@ inline void inform( location where, text expr )
 
 // Expression decomposition:
 
+// containers are written with at most max_elements elements (0: all) and
+// nested at most max_depth deep; see option --max-elements. The limits are
+// per thread, as tests that run on several threads may call run() themselves:
+
+struct string_limits
+{
+    std::size_t max_elements;
+    int max_depth;
+};
+
+inline string_limits & to_string_limits()
+{
+    static thread_local string_limits limits = { lest_FEATURE_MAX_ELEMENTS, lest_FEATURE_MAX_DEPTH };
+    return limits;
+}
+
 template< typename T >
 auto make_value_string( T const & value ) -> std::string;
 
@@ -549,36 +660,87 @@ inline char const * sfx( char const  * txt ) { return txt; }
 inline char const * sfx( char const  *      ) { return ""; }
 #endif
 
-inline std::string transformed( char chr )
+// escape table: per character its length and text in reported strings;
+// backslash and control characters are escaped:
+
+struct escape
 {
-    struct Tr { char chr; char const * str; } table[] =
-    {
-        {'\\', "\\\\" },
-        {'\r', "\\r"  }, {'\f', "\\f" },
-        {'\n', "\\n"  }, {'\t', "\\t" },
-    };
+    unsigned char size;
+    char text[5];
+};
 
-    for ( auto tr : table )
+inline escape const * escape_table()
+{
+    static const struct table_type
     {
-        if ( chr == tr.chr )
-            return tr.str;
-    }
+        escape entry[256];
+
+        table_type() : entry()
+        {
+            const char hex[] = "0123456789abcdef";
+
+            for ( int c = 0; c < 256; ++c )
+            {
+                escape & e = entry[c];
+
+                if      ( c == '\\' ) { e.size = 2; e.text[0] = '\\'; e.text[1] = '\\'; }
+                else if ( c == '\r'  ) { e.size = 2; e.text[0] = '\\'; e.text[1] = 'r';  }
+                else if ( c == '\f'  ) { e.size = 2; e.text[0] = '\\'; e.text[1] = 'f';  }
+                else if ( c == '\n'  ) { e.size = 2; e.text[0] = '\\'; e.text[1] = 'n';  }
+                else if ( c == '\t'  ) { e.size = 2; e.text[0] = '\\'; e.text[1] = 't';  }
+                else if ( c < ' '    ) { e.size = 4; e.text[0] = '\\'; e.text[1] = 'x'; e.text[2] = hex[ c >> 4 ]; e.text[3] = hex[ c & 0xf ]; }
+                else                   { e.size = 1; e.text[0] = static_cast<char>( c ); }
+            }
+        }
+    } table;
+
+    return table.entry;
+}
+
+// append txt to buffer, escaping characters via the table:
 
-    auto unprintable = [](char c){ return 0 <= c && c < ' '; };
+inline void append_escaped( std::string & buffer, char const * txt, std::size_t n )
+{
+    escape const * table = escape_table();
 
-    auto to_hex_string = [](char c)
+    for ( std::size_t i = 0; i < n; )
     {
-        std::ostringstream os;
-        os << "\\x" << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>( static_cast<unsigned char>(c) );
-        return os.str();
-    };
+        std::size_t run = i;
+        while ( run < n && table[ static_cast<unsigned char>( txt[run] ) ].size == 1 )
+            ++run;
+
+        buffer.append( txt + i, run - i );
+
+        if ( run < n )
+        {
+            escape const & e = table[ static_cast<unsigned char>( txt[run] ) ];
+            buffer.append( e.text, e.size );
+            ++run;
+        }
+        i = run;
+    }
+}
+
+inline std::string transformed( char chr )
+{
+    escape const & e = escape_table()[ static_cast<unsigned char>( chr ) ];
+    return std::string( e.text, e.size );
+}
 
-    return unprintable( chr  ) ? to_hex_string( chr ) : std::string( 1, chr );
+inline std::string make_quoted_string( char quote, char const * txt, std::size_t n )
+{
+    std::string result;
+    result.reserve( n + 2 );
+    result += quote;
+    append_escaped( result, txt, n );
+    result += quote;
+    return result;
 }
 
-inline std::string make_tran_string( std::string const & txt ) { std::ostringstream os; for(auto c:txt) os << transformed(c); return os.str(); }
-inline std::string make_strg_string( std::string const & txt ) { return "\"" + make_tran_string(                 txt   ) + "\"" ; }
-inline std::string make_char_string(                char chr ) { return "\'" + make_tran_string( std::string( 1, chr ) ) + "\'" ; }
+inline std::string make_tran_string( std::string const & txt ) { std::string result; result.reserve( txt.size() ); append_escaped( result, txt.data(), txt.size() ); return result; }
+inline std::string make_strg_string( std::string const & txt ) { return make_quoted_string( '\"', txt.data(), txt.size() ); }
+inline std::string make_strg_string( char const *        txt ) { return make_quoted_string( '\"', txt, std::strlen( txt ) ); }
+inline std::string make_char_string(                char chr ) { return make_quoted_string( '\'', &chr, 1 ); }
 
 inline std::string to_string( std::nullptr_t              ) { return "nullptr"; }
 inline std::string to_string( std::string     const & txt ) { return make_strg_string( txt ); }
@@ -754,16 +916,64 @@ auto to_string( T const & item ) -> ForNonContainerNonPointer<T, std::string>
     return make_string( item );
 }
 
+template< typename T >
+struct is_nested : std::integral_constant< bool, is_container<T>::value &&
+    ! std::is_same<T, std::string>::value && ! std::is_same<T, std::wstring>::value > {};
+
 template< typename C >
-auto to_string( C const & cont ) -> ForContainer<C, std::string>
+void write_container( std::ostream & os, C const & cont, std::size_t max_elements, int depth = 1 );
+
+template< typename T >
+void write_element( std::ostream & os, T const & item, std::size_t, int, std::false_type )
 {
-    std::ostringstream os;
+    os << to_string( item );
+}
+
+template< typename C >
+void write_element( std::ostream & os, C const & cont, std::size_t max_elements, int depth, std::true_type )
+{
+    write_container( os, cont, max_elements, depth + 1 );
+}
+
+// write container elements directly to the stream, eliding the elements
+// beyond max_elements and containers nested beyond the maximum depth:
+
+template< typename C >
+void write_container( std::ostream & os, C const & cont, std::size_t max_elements, int depth )
+{
+    if ( depth > to_string_limits().max_depth )
+    {
+        os << "{ ... }";
+        return;
+    }
+
     os << "{ ";
-    for ( auto & x : cont )
+
+    auto pos = std::begin( cont );
+    for ( std::size_t i = 0; pos != std::end( cont ) && ( max_elements == 0 || i < max_elements ); ++pos, ++i )
+    {
+        write_element( os, *pos, max_elements, depth, is_nested< typename std::decay<decltype( *pos )>::type >() );
+        os << ", ";
+    }
+
+    if ( pos != std::end( cont ) )
     {
-        os << to_string( x ) << ", ";
+        os << "... (" << std::distance( pos, std::end( cont ) ) << " more) ";
     }
     os << "}";
+}
+
+template< typename T >
+void write_string( std::ostream & os, T const & item )
+{
+    write_element( os, item, to_string_limits().max_elements, 0, is_nested<T>() );
+}
+
+template< typename C >
+auto to_string( C const & cont ) -> ForContainer<C, std::string>
+{
+    std::ostringstream os;
+    write_container( os, cont, to_string_limits().max_elements );
     return os.str();
 }
 
@@ -781,12 +991,68 @@ auto to_string( std::wstring const & txt ) -> std::string
 }
 #endif
 
+// numbers are formatted into a local buffer, without a stream; floating
+// point numbers as by an ostream with default precision (%g):
+
 template< typename T >
-auto make_value_string( T const & value ) -> std::string
+auto make_number_string( T const & value, std::true_type /*integral*/ ) -> std::string
+{
+    char buffer[ std::numeric_limits<T>::digits10 + 3 ];
+#if lest_HAVE_TO_CHARS
+    const auto end = std::to_chars( buffer, buffer + sizeof buffer, value ).ptr;
+    return std::string( buffer, end );
+#else
+    using U = typename std::make_unsigned<T>::type;
+
+    const bool negative = value < 0;
+    U magnitude = negative ? static_cast<U>( U( 0 ) - static_cast<U>( value ) ) : static_cast<U>( value );
+
+    char * pos = buffer + sizeof buffer;
+    do
+    {
+        *--pos = static_cast<char>( '0' + magnitude % 10 );
+        magnitude /= 10;
+    }
+    while ( magnitude != 0 );
+
+    if ( negative )
+        *--pos = '-';
+
+    return std::string( pos, buffer + sizeof buffer );
+#endif
+}
+
+template< typename T >
+auto make_number_string( T const & value, std::false_type /*floating point*/ ) -> std::string
+{
+    char buffer[ 32 ];
+#if lest_HAVE_TO_CHARS
+    const auto end = std::to_chars( buffer, buffer + sizeof buffer, value, std::chars_format::general, 6 ).ptr;
+    return std::string( buffer, end );
+#else
+    const int size = std::snprintf( buffer, sizeof buffer, "%g", static_cast<double>( value ) );
+    return std::string( buffer, static_cast<std::size_t>( size ) );
+#endif
+}
+
+template< typename T >
+auto make_value_string( T const & value, std::true_type /*arithmetic*/ ) -> std::string
+{
+    return make_number_string( value, std::is_integral<T>() );
+}
+
+template< typename T >
+auto make_value_string( T const & value, std::false_type /*arithmetic*/ ) -> std::string
 {
     std::ostringstream os; os << value; return os.str();
 }
 
+template< typename T >
+auto make_value_string( T const & value ) -> std::string
+{
+    return make_value_string( value, std::is_arithmetic<T>() );
+}
+
 inline
 auto make_memory_string( void const * item, std::size_t size ) -> std::string
 {
@@ -829,32 +1095,53 @@ auto to_string( approx const & appr ) -> std::string
 template< typename L, typename R >
 auto to_string( L const & lhs, std::string op, R const & rhs ) -> std::string
 {
-    std::ostringstream os; os << to_string( lhs ) << " " << op << " " << to_string( rhs ); return os.str();
+    std::ostringstream os; write_string( os, lhs ); os << " " << op << " "; write_string( os, rhs ); return os.str();
 }
 
+// the decomposition text is only built for an outcome that is reported,
+// as given by describe_true and describe_false:
+
 template< typename L >
 struct expression_lhs
 {
     const L lhs;
+    const bool describe_true;
+    const bool describe_false;
+
+    expression_lhs( L lhs_, bool describe_true_, bool describe_false_ )
+    : lhs( lhs_), describe_true( describe_true_), describe_false( describe_false_) {}
+
+    operator result() { const bool value = !!lhs; return result{ value, describe( value ) ? to_string( lhs ) : text() }; }
 
-    expression_lhs( L lhs_) : lhs( lhs_) {}
+    template< typename R > result operator==( R const & rhs ) { return make_result( !!( lhs == rhs ), "==", rhs ); }
+    template< typename R > result operator!=( R const & rhs ) { return make_result( !!( lhs != rhs ), "!=", rhs ); }
+    template< typename R > result operator< ( R const & rhs ) { return make_result( !!( lhs <  rhs ), "<" , rhs ); }
+    template< typename R > result operator<=( R const & rhs ) { return make_result( !!( lhs <= rhs ), "<=", rhs ); }
+    template< typename R > result operator> ( R const & rhs ) { return make_result( !!( lhs >  rhs ), ">" , rhs ); }
+    template< typename R > result operator>=( R const & rhs ) { return make_result( !!( lhs >= rhs ), ">=", rhs ); }
 
-    operator result() { return result{ !!lhs, to_string( lhs ) }; }
+private:
+    bool describe( bool value ) const { return value ? describe_true : describe_false; }
 
-    template< typename R > result operator==( R const & rhs ) { return result{ lhs == rhs, to_string( lhs, "==", rhs ) }; }
-    template< typename R > result operator!=( R const & rhs ) { return result{ lhs != rhs, to_string( lhs, "!=", rhs ) }; }
-    template< typename R > result operator< ( R const & rhs ) { return result{ lhs <  rhs, to_string( lhs, "<" , rhs ) }; }
-    template< typename R > result operator<=( R const & rhs ) { return result{ lhs <= rhs, to_string( lhs, "<=", rhs ) }; }
-    template< typename R > result operator> ( R const & rhs ) { return result{ lhs >  rhs, to_string( lhs, ">" , rhs ) }; }
-    template< typename R > result operator>=( R const & rhs ) { return result{ lhs >= rhs, to_string( lhs, ">=", rhs ) }; }
+    template< typename R >
+    result make_result( bool value, char const * op, R const & rhs )
+    {
+        return result{ value, describe( value ) ? to_string( lhs, op, rhs ) : text() };
+    }
 };
 
 struct expression_decomposer
 {
+    const bool describe_true;
+    const bool describe_false;
+
+    expression_decomposer( bool describe_true_ = true, bool describe_false_ = true )
+    : describe_true( describe_true_), describe_false( describe_false_) {}
+
     template <typename L>
     expression_lhs<L const &> operator<< ( L const & operand )
     {
-        return expression_lhs<L const &>( operand );
+        return expression_lhs<L const &>( operand, describe_true, describe_false );
     }
 };
 
@@ -931,349 +1218,1966 @@ inline void report( std::ostream & os, message const & e, text test )
     os << e.where << ": " << colourise( e.kind ) << e.note << ": " << test << ": " << colourise( e.what() ) << std::endl;
 }
 
-// Test runner:
+// Substring search:
 
-#if lest_FEATURE_REGEX_SEARCH
-    inline bool search( text re, text line )
-    {
-        return std::regex_search( line, std::regex( re ) );
-    }
-#else
-    inline bool search( text part, text line )
-    {
-        auto case_insensitive_equal = []( char a, char b )
-        {
-            return tolower( a ) == tolower( b );
-        };
+inline bool equal_chars( char const * a, char const * b, std::size_t n, bool icase )
+{
+    if ( ! icase )
+        return 0 == std::memcmp( a, b, n );
 
-        return std::search(
-            line.begin(), line.end(),
-            part.begin(), part.end(), case_insensitive_equal ) != line.end();
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        if ( std::tolower( static_cast<unsigned char>( a[i] ) ) != std::tolower( static_cast<unsigned char>( b[i] ) ) )
+            return false;
     }
-#endif
+    return true;
+}
 
-inline bool match( texts whats, text line )
+inline std::size_t find_text_scalar( char const * text, std::size_t n, char const * part, std::size_t m, bool icase, std::size_t from = 0 )
 {
-    for ( auto & what : whats )
+    for ( std::size_t i = from; i + m <= n; ++i )
     {
-        if ( search( what, line ) )
-            return true;
+        if ( equal_chars( text + i, part, m, icase ) )
+            return i;
     }
-    return false;
+    return n;
 }
 
-inline bool select( text name, texts include )
-{
-    auto none = []( texts args ) { return args.size() == 0; };
+#if lest_FEATURE_SIMD_SEARCH
 
-#if lest_FEATURE_REGEX_SEARCH
-    auto hidden = []( text arg ){ return match( { "\\[\\..*", "\\[hide\\]" }, arg ); };
+inline int lowest_bit( unsigned mask )
+{
+#ifdef _MSC_VER
+    unsigned long index; _BitScanForward( &index, mask ); return static_cast<int>( index );
 #else
-    auto hidden = []( text arg ){ return match( { "[.", "[hide]" }, arg ); };
+    return __builtin_ctz( mask );
 #endif
+}
 
-    if ( none( include ) )
-    {
-        return ! hidden( name );
-    }
+// Compare the first and the last character of part at 16 positions at once and
+// verify candidates; for icase, compare against both cases of these characters.
 
-    bool any = false;
-    for ( auto pos = include.rbegin(); pos != include.rend(); ++pos )
-    {
-        auto & part = *pos;
+inline std::size_t find_text_sse2( char const * text, std::size_t n, char const * part, std::size_t m, bool icase )
+{
+    const char lf = static_cast<char>( std::tolower( static_cast<unsigned char>( part[0    ] ) ) );
+    const char ll = static_cast<char>( std::tolower( static_cast<unsigned char>( part[m - 1] ) ) );
 
-        if ( part == "@" || part == "*" )
-            return true;
+    const __m128i first_lo = _mm_set1_epi8( icase ? lf : part[0] );
+    const __m128i last_lo  = _mm_set1_epi8( icase ? ll : part[m - 1] );
+    const __m128i first_up = _mm_set1_epi8( icase ? static_cast<char>( std::toupper( static_cast<unsigned char>( lf ) ) ) : part[0] );
+    const __m128i last_up  = _mm_set1_epi8( icase ? static_cast<char>( std::toupper( static_cast<unsigned char>( ll ) ) ) : part[m - 1] );
 
-        if ( search( part, name ) )
-            return true;
+    std::size_t i = 0;
+    for ( ; i + m - 1 + 16 <= n; i += 16 )
+    {
+        const __m128i block_first = _mm_loadu_si128( reinterpret_cast<__m128i const *>( text + i ) );
+        const __m128i block_last  = _mm_loadu_si128( reinterpret_cast<__m128i const *>( text + i + m - 1 ) );
 
-        if ( '!' == part[0] )
+        const __m128i eq_first = _mm_or_si128( _mm_cmpeq_epi8( block_first, first_lo ), _mm_cmpeq_epi8( block_first, first_up ) );
+        const __m128i eq_last  = _mm_or_si128( _mm_cmpeq_epi8( block_last , last_lo  ), _mm_cmpeq_epi8( block_last , last_up  ) );
+
+        for ( unsigned mask = static_cast<unsigned>( _mm_movemask_epi8( _mm_and_si128( eq_first, eq_last ) ) ); mask != 0; mask &= mask - 1 )
         {
-            any = true;
-            if ( search( part.substr(1), name ) )
-                return false;
+            const std::size_t pos = i + static_cast<std::size_t>( lowest_bit( mask ) );
+
+            if ( equal_chars( text + pos, part, m, icase ) )
+                return pos;
         }
-        else
+    }
+    return find_text_scalar( text, n, part, m, icase, i );
+}
+
+#if lest_HAVE_AVX2_DISPATCH
+
+__attribute__(( target( "avx2" ) ))
+inline std::size_t find_text_avx2( char const * text, std::size_t n, char const * part, std::size_t m, bool icase )
+{
+    const char lf = static_cast<char>( std::tolower( static_cast<unsigned char>( part[0    ] ) ) );
+    const char ll = static_cast<char>( std::tolower( static_cast<unsigned char>( part[m - 1] ) ) );
+
+    const __m256i first_lo = _mm256_set1_epi8( icase ? lf : part[0] );
+    const __m256i last_lo  = _mm256_set1_epi8( icase ? ll : part[m - 1] );
+    const __m256i first_up = _mm256_set1_epi8( icase ? static_cast<char>( std::toupper( static_cast<unsigned char>( lf ) ) ) : part[0] );
+    const __m256i last_up  = _mm256_set1_epi8( icase ? static_cast<char>( std::toupper( static_cast<unsigned char>( ll ) ) ) : part[m - 1] );
+
+    std::size_t i = 0;
+    for ( ; i + m - 1 + 32 <= n; i += 32 )
+    {
+        const __m256i block_first = _mm256_loadu_si256( reinterpret_cast<__m256i const *>( text + i ) );
+        const __m256i block_last  = _mm256_loadu_si256( reinterpret_cast<__m256i const *>( text + i + m - 1 ) );
+
+        const __m256i eq_first = _mm256_or_si256( _mm256_cmpeq_epi8( block_first, first_lo ), _mm256_cmpeq_epi8( block_first, first_up ) );
+        const __m256i eq_last  = _mm256_or_si256( _mm256_cmpeq_epi8( block_last , last_lo  ), _mm256_cmpeq_epi8( block_last , last_up  ) );
+
+        for ( unsigned mask = static_cast<unsigned>( _mm256_movemask_epi8( _mm256_and_si256( eq_first, eq_last ) ) ); mask != 0; mask &= mask - 1 )
         {
-            any = false;
+            const std::size_t pos = i + static_cast<std::size_t>( lowest_bit( mask ) );
+
+            if ( equal_chars( text + pos, part, m, icase ) )
+                return pos;
         }
     }
-    return any && ! hidden( name );
+    return find_text_sse2( text + i, n - i, part, m, icase ) + i;
 }
 
-inline int indefinite( int repeat ) { return repeat == -1; }
+inline bool has_avx2()
+{
+    static const bool avx2 = __builtin_cpu_supports( "avx2" );
+    return avx2;
+}
+#endif // lest_HAVE_AVX2_DISPATCH
+#endif // lest_FEATURE_SIMD_SEARCH
 
-using seed_t = std::mt19937::result_type;
+// Position of part in text, or n if absent; vectorised where available:
 
-struct options
+inline std::size_t find_text( char const * text, std::size_t n, char const * part, std::size_t m, bool icase = false )
 {
-    bool help    = false;
-    bool abort   = false;
-    bool count   = false;
-    bool list    = false;
-    bool tags    = false;
-    bool time    = false;
-    bool pass    = false;
-    bool zen     = false;
-    bool lexical = false;
-    bool random  = false;
-    bool verbose = false;
-    bool version = false;
-    int  repeat  = 1;
-    seed_t seed  = 0;
-};
+    if ( m == 0 )
+        return 0;
 
-struct env
+    if ( m > n )
+        return n;
+
+#if lest_FEATURE_SIMD_SEARCH
+# if lest_HAVE_AVX2_DISPATCH
+    if ( has_avx2() )
+        return find_text_avx2( text, n, part, m, icase );
+# endif
+    return find_text_sse2( text, n, part, m, icase );
+#else
+    return find_text_scalar( text, n, part, m, icase );
+#endif
+}
+
+// regex_unsupported: expression uses a construct linear_regex cannot handle:
+
+struct regex_unsupported : std::runtime_error
 {
-    std::ostream & os;
-    options opt;
-    text testing;
-    std::vector< text > ctx;
+    explicit regex_unsupported( std::string const & what ) : std::runtime_error( what ) { }
+};
 
-    env( std::ostream & out, options option )
-    : os( out ), opt( option ), testing(), ctx() {}
+// linear_regex: regular expression engine for a subset of ECMAScript that runs
+// in time linear in the length of the subject string. The expression is
+// compiled to a Thompson NFA that is simulated via a lazily built DFA.
+// It serves the regexp matchers of hamlest and, with lest_FEATURE_LINEAR_REGEX,
+// test selection under lest_FEATURE_REGEX_SEARCH.
+//
+// Supported: literals, ., [...], [^...], \d \D \w \W \s \S, \t \n \r \f \v \0 \xHH,
+// escaped metacharacters, (...), (?:...), |, *, +, ?, {n}, {n,}, {n,m}, lazy
+// quantifiers, ^ and $. Other constructs throw regex_unsupported:
 
-    env & operator()( text test )
+class linear_regex
+{
+public:
+    linear_regex( std::string const & expr, bool icase )
+    : sets(), prog(), search_start( 0 ), match_start( 3 ), mutex(), idle()
     {
-        clear(); testing = test; return *this;
+        node tree = parser( expr, icase, sets ).parse();
+
+        // search program: an unanchored .*? loop in front of the expression:
+
+        emit( inst::split, match_start, 1 );
+        emit( inst::set, add_set( charset().set() ) );
+        emit( inst::jmp, search_start );
+        compile( tree );
+        emit( inst::match );
     }
 
-    bool abort() { return opt.abort; }
-    bool pass()  { return opt.pass; }
-    bool zen()   { return opt.zen; }
+    bool match ( std::string const & text ) const { return run( text, match_start, false ); }
 
-    void clear() { ctx.clear(); }
-    void pop()   { ctx.pop_back(); }
-    void push( text proposition ) { ctx.emplace_back( proposition ); }
+    bool search( std::string const & text ) const { return run( text, search_start, true ); }
 
-    text context() { return testing + sections(); }
+private:
+    using charset = std::bitset<256>;
 
-    text sections()
+    static const std::size_t max_program = 20000;
+    static const std::size_t max_states  =  2000;
+
+    struct node
     {
-        if ( ! opt.verbose )
-            return "";
+        enum kind_t { set, cat, alt, rep, bol, eol } kind;
+        int index;
+        int min, max;
+        std::vector<node> kids;
 
-        text msg;
-        for( auto section : ctx )
+        explicit node( kind_t kind, int index = 0, int min = 0, int max = 0 ) : kind( kind ), index( index ), min( min ), max( max ), kids() { }
+    };
+
+    struct inst
+    {
+        enum op_t { set, split, jmp, bol, eol, match } op;
+        int x, y;
+    };
+
+    struct state
+    {
+        std::vector<int> pcs;
+        bool matched;
+        bool accepts;
+        std::vector<int> next;
+    };
+
+    // lazily built DFA; a thread scanning the text owns one while it runs:
+
+    struct dfa
+    {
+        std::vector<state> states;
+        std::map<std::vector<int>, int> index;
+        std::vector<unsigned> mark;
+        unsigned generation;
+
+        dfa() : states(), index(), mark(), generation( 0 ) { }
+    };
+
+    class parser
+    {
+    public:
+        parser( std::string const & expr, bool icase, std::vector<charset> & sets )
+        : expr( expr ), pos( 0 ), icase( icase ), sets( sets ) { }
+
+        node parse()
         {
-            msg += "\n  " + section;
+            node tree = parse_alt();
+
+            if ( pos != expr.size() )
+                unsupported();
+
+            return tree;
         }
-        return msg;
+
+    private:
+        bool at_end() const { return pos >= expr.size(); }
+
+        char peek() const { return at_end() ? '\0' : expr[pos]; }
+
+        char next()
+        {
+            if ( at_end() )
+                unsupported();
+            return expr[pos++];
+        }
+
+        bool consume( char chr )
+        {
+            if ( at_end() || expr[pos] != chr )
+                return false;
+            ++pos; return true;
+        }
+
+        [[noreturn]] void unsupported() const
+        {
+            throw regex_unsupported( "linear_regex: unsupported expression " + lest::to_string( expr ) );
+        }
+
+        node parse_alt()
+        {
+            node result( node::alt );
+            result.kids.push_back( parse_cat() );
+
+            while ( consume( '|' ) )
+                result.kids.push_back( parse_cat() );
+
+            return result.kids.size() == 1 ? result.kids.front() : result;
+        }
+
+        node parse_cat()
+        {
+            node result( node::cat );
+
+            while ( ! at_end() && peek() != '|' && peek() != ')' )
+                result.kids.push_back( parse_rep() );
+
+            return result;
+        }
+
+        node parse_rep()
+        {
+            node atom = parse_atom();
+
+            int min = 0, max = -1;
+
+            if      ( consume( '*' ) ) { min = 0; max = -1; }
+            else if ( consume( '+' ) ) { min = 1; max = -1; }
+            else if ( consume( '?' ) ) { min = 0; max =  1; }
+            else if ( consume( '{' ) ) { parse_bounds( min, max ); }
+            else return atom;
+
+            // laziness does not affect whether there is a match:
+            consume( '?' );
+
+            // like std::regex, reject a quantifier that follows a quantifier, e.g. a** and a{2}{3}:
+
+            if ( atom.kind == node::bol || atom.kind == node::eol || is_quantifier( peek() ) )
+                unsupported();
+
+            node result( node::rep, 0, min, max );
+            result.kids.push_back( atom );
+            return result;
+        }
+
+        static bool is_quantifier( char chr )
+        {
+            return chr == '*' || chr == '+' || chr == '?' || chr == '{';
+        }
+
+        void parse_bounds( int & min, int & max )
+        {
+            min = max = parse_number();
+
+            if ( consume( ',' ) )
+                max = peek() == '}' ? -1 : parse_number();
+
+            if ( ! consume( '}' ) || ( max != -1 && max < min ) || max > 1000 )
+                unsupported();
+        }
+
+        int parse_number()
+        {
+            if ( ! std::isdigit( static_cast<unsigned char>( peek() ) ) )
+                unsupported();
+
+            int value = 0;
+            while ( std::isdigit( static_cast<unsigned char>( peek() ) ) && value <= 1000 )
+                value = 10 * value + ( next() - '0' );
+
+            return value;
+        }
+
+        node parse_atom()
+        {
+            const char chr = next();
+
+            switch ( chr )
+            {
+                case '(':
+                {
+                    if ( consume( '?' ) && ! consume( ':' ) )
+                        unsupported();
+
+                    node group = parse_alt();
+
+                    if ( ! consume( ')' ) )
+                        unsupported();
+
+                    return group;
+                }
+                case '^': return node( node::bol );
+                case '$': return node( node::eol );
+                case '.': return make_set( charset().set().reset( '\n' ).reset( '\r' ) );
+                case '[': return make_set( parse_class() );
+                case '\\':
+                {
+                    charset set;
+                    parse_escape( set, false );
+                    return make_set( set );
+                }
+                case ')': case '*': case '+': case '?': case '{': case '}': case ']':
+                    unsupported();
+                default:
+                    return make_set( charset().set( static_cast<unsigned char>( chr ) ) );
+            }
+        }
+
+        charset parse_class()
+        {
+            const bool negate = consume( '^' );
+
+            charset set;
+            while ( ! consume( ']' ) )
+            {
+                charset item;
+                const bool single = parse_class_atom( item );
+
+                if ( peek() == '-' && pos + 1 < expr.size() && expr[pos + 1] != ']' )
+                {
+                    ++pos;
+                    charset last;
+                    if ( ! single || ! parse_class_atom( last ) )
+                        unsupported();
+
+                    const int from = first_of( item ), to = first_of( last );
+                    if ( from > to )
+                        unsupported();
+
+                    for ( int c = from; c <= to; ++c )
+                        item.set( static_cast<std::size_t>( c ) );
+                }
+                set |= item;
+            }
+            return negate ? fold( set ).flip() : set;
+        }
+
+        // true if the class atom is a single character:
+
+        bool parse_class_atom( charset & set )
+        {
+            const char chr = next();
+
+            if ( chr != '\\' )
+            {
+                set.set( static_cast<unsigned char>( chr ) );
+                return true;
+            }
+            return parse_escape( set, true );
+        }
+
+        // true if the escape denotes a single character:
+
+        bool parse_escape( charset & set, bool in_class )
+        {
+            const char chr = next();
+
+            switch ( chr )
+            {
+                case 'd': set |= digit(); return false;
+                case 'D': set |= ~digit(); return false;
+                case 'w': set |= word(); return false;
+                case 'W': set |= ~word(); return false;
+                case 's': set |= space(); return false;
+                case 'S': set |= ~space(); return false;
+                case 't': set.set( '\t' ); return true;
+                case 'n': set.set( '\n' ); return true;
+                case 'r': set.set( '\r' ); return true;
+                case 'f': set.set( '\f' ); return true;
+                case 'v': set.set( '\v' ); return true;
+                case 'b': if ( ! in_class ) unsupported(); set.set( '\b' ); return true;
+                case '0': if ( std::isdigit( static_cast<unsigned char>( peek() ) ) ) unsupported(); set.set( 0 ); return true;
+                case 'x': set.set( static_cast<std::size_t>( 16 * parse_hex() + parse_hex() ) ); return true;
+                default:
+                    if ( std::isalnum( static_cast<unsigned char>( chr ) ) )
+                        unsupported();
+                    set.set( static_cast<unsigned char>( chr ) );
+                    return true;
+            }
+        }
+
+        int parse_hex()
+        {
+            const char chr = next();
+
+            if ( ! std::isxdigit( static_cast<unsigned char>( chr ) ) )
+                unsupported();
+
+            return std::isdigit( static_cast<unsigned char>( chr ) ) ? chr - '0' : std::tolower( static_cast<unsigned char>( chr ) ) - 'a' + 10;
+        }
+
+        static int first_of( charset const & set )
+        {
+            for ( std::size_t c = 0; c < set.size(); ++c )
+                if ( set[c] ) return static_cast<int>( c );
+            return 0;
+        }
+
+        static charset range( int from, int to )
+        {
+            charset set;
+            for ( int c = from; c <= to; ++c )
+                set.set( static_cast<std::size_t>( c ) );
+            return set;
+        }
+
+        static charset digit() { return range( '0', '9' ); }
+        static charset word()  { return range( '0', '9' ) | range( 'A', 'Z' ) | range( 'a', 'z' ) | charset().set( '_' ); }
+        static charset space() { return range( '\t', '\r' ) | charset().set( ' ' ); }
+
+        charset fold( charset set ) const
+        {
+            if ( icase )
+            {
+                for ( int c = 'a'; c <= 'z'; ++c )
+                {
+                    const std::size_t lower = static_cast<std::size_t>( c ), upper = static_cast<std::size_t>( c - 'a' + 'A' );
+                    if ( set[lower] || set[upper] )
+                        set.set( lower ).set( upper );
+                }
+            }
+            return set;
+        }
+
+        node make_set( charset const & set )
+        {
+            sets.push_back( fold( set ) );
+            return node( node::set, static_cast<int>( sets.size() - 1 ) );
+        }
+
+        std::string const & expr;
+        std::size_t pos;
+        bool icase;
+        std::vector<charset> & sets;
+    };
+
+    int add_set( charset const & set )
+    {
+        sets.push_back( set );
+        return static_cast<int>( sets.size() - 1 );
+    }
+
+    int emit( inst::op_t op, int x = 0, int y = 0 )
+    {
+        if ( prog.size() >= max_program )
+            throw regex_unsupported( "linear_regex: expression too large" );
+
+        prog.push_back( inst{ op, x, y } );
+        return static_cast<int>( prog.size() - 1 );
+    }
+
+    int here() const { return static_cast<int>( prog.size() ); }
+
+    void compile( node const & tree )
+    {
+        switch ( tree.kind )
+        {
+            case node::set: emit( inst::set, tree.index ); break;
+            case node::bol: emit( inst::bol ); break;
+            case node::eol: emit( inst::eol ); break;
+            case node::cat:
+                for ( auto const & kid : tree.kids )
+                    compile( kid );
+                break;
+            case node::alt:
+            {
+                std::vector<int> jumps;
+                for ( std::size_t i = 0; i + 1 < tree.kids.size(); ++i )
+                {
+                    const int split = emit( inst::split, here() + 1 );
+                    compile( tree.kids[i] );
+                    jumps.push_back( emit( inst::jmp ) );
+                    prog[ split ].y = here();
+                }
+                compile( tree.kids.back() );
+
+                for ( auto jump : jumps )
+                    prog[ jump ].x = here();
+                break;
+            }
+            case node::rep:
+            {
+                for ( int i = 0; i < tree.min; ++i )
+                    compile( tree.kids.front() );
+
+                if ( tree.max == -1 )
+                {
+                    const int split = emit( inst::split, here() + 1 );
+                    compile( tree.kids.front() );
+                    emit( inst::jmp, split );
+                    prog[ split ].y = here();
+                }
+                else
+                {
+                    std::vector<int> splits;
+                    for ( int i = tree.min; i < tree.max; ++i )
+                    {
+                        splits.push_back( emit( inst::split, here() + 1 ) );
+                        compile( tree.kids.front() );
+                    }
+                    for ( auto split : splits )
+                        prog[ split ].y = here();
+                }
+                break;
+            }
+        }
+    }
+
+    // sorted set of set, match and pending eol instructions reachable from pcs:
+
+    std::vector<int> closure( dfa & cache, std::vector<int> stack, bool bol, bool eol ) const
+    {
+        auto & mark = cache.mark;
+        auto & generation = cache.generation;
+
+        if ( ++generation == 0 )
+        {
+            std::fill( mark.begin(), mark.end(), 0u ); generation = 1;
+        }
+        mark.resize( prog.size(), 0u );
+
+        std::vector<int> result;
+        while ( ! stack.empty() )
+        {
+            const int pc = stack.back(); stack.pop_back();
+
+            if ( mark[pc] == generation )
+                continue;
+            mark[pc] = generation;
+
+            inst const & in = prog[pc];
+            switch ( in.op )
+            {
+                case inst::set:
+                case inst::match: result.push_back( pc ); break;
+                case inst::jmp:   stack.push_back( in.x ); break;
+                case inst::split: stack.push_back( in.y ); stack.push_back( in.x ); break;
+                case inst::bol:   if ( bol ) stack.push_back( pc + 1 ); break;
+                case inst::eol:   if ( eol ) stack.push_back( pc + 1 ); else result.push_back( pc ); break;
+            }
+        }
+        std::sort( result.begin(), result.end() );
+        return result;
+    }
+
+    bool contains_match( std::vector<int> const & pcs ) const
+    {
+        return std::any_of( pcs.begin(), pcs.end(), [this]( int pc ) { return prog[pc].op == inst::match; } );
+    }
+
+    bool accepts_at_end( dfa & cache, std::vector<int> const & pcs, bool bol ) const
+    {
+        std::vector<int> stack;
+        for ( auto pc : pcs )
+        {
+            if ( prog[pc].op == inst::eol )
+                stack.push_back( pc + 1 );
+        }
+        return contains_match( pcs ) || contains_match( closure( cache, stack, bol, true ) );
+    }
+
+    int state_of( dfa & cache, std::vector<int> const & pcs ) const
+    {
+        auto pos = cache.index.find( pcs );
+
+        if ( pos != cache.index.end() )
+            return pos->second;
+
+        cache.states.push_back( state{ pcs, contains_match( pcs ), accepts_at_end( cache, pcs, false ), std::vector<int>( 256, -1 ) } );
+        return cache.index[ pcs ] = static_cast<int>( cache.states.size() - 1 );
+    }
+
+    int transition( dfa & cache, int from, unsigned char chr ) const
+    {
+        std::vector<int> stack;
+        for ( auto pc : cache.states[from].pcs )
+        {
+            if ( prog[pc].op == inst::set && sets[ prog[pc].x ][ chr ] )
+                stack.push_back( pc + 1 );
+        }
+        std::vector<int> pcs = closure( cache, stack, false, false );
+
+        // bound memory use by flushing the DFA cache when it grows too large:
+
+        if ( cache.states.size() >= max_states )
+        {
+            cache.states.clear(); cache.index.clear();
+            return state_of( cache, pcs );
+        }
+        return cache.states[from].next[chr] = state_of( cache, pcs );
+    }
+
+    // take an idle DFA, or a new one when all are in use by other threads;
+    // only handing DFAs out and back in is serialised, not the scan:
+
+    bool run( std::string const & text, int start, bool searching ) const
+    {
+        std::unique_ptr<dfa> cache;
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+
+            if ( idle.empty() )
+            {
+                cache.reset( new dfa() );
+            }
+            else
+            {
+                cache = std::move( idle.back() ); idle.pop_back();
+            }
+        }
+
+        const bool result = run( *cache, text, start, searching );
+
+        std::lock_guard<std::mutex> lock( mutex );
+        idle.push_back( std::move( cache ) );
+
+        return result;
+    }
+
+    bool run( dfa & cache, std::string const & text, int start, bool searching ) const
+    {
+        auto const & states = cache.states;
+
+        std::vector<int> pcs = closure( cache, std::vector<int>{ start }, true, false );
+
+        if ( text.empty() )
+            return accepts_at_end( cache, pcs, true );
+
+        int current = state_of( cache, pcs );
+
+        for ( auto chr : text )
+        {
+            if ( searching && states[current].matched )
+                return true;
+
+            if ( states[current].pcs.empty() )
+                return false;
+
+            const unsigned char c = static_cast<unsigned char>( chr );
+            const int next = states[current].next[c];
+
+            current = next >= 0 ? next : transition( cache, current, c );
+        }
+        return states[current].accepts;
     }
+
+    std::vector<charset> sets;
+    std::vector<inst> prog;
+    const int search_start;
+    const int match_start;
+
+    // DFAs not in use, kept warm for the next scan of this expression:
+
+    mutable std::mutex mutex;
+    mutable std::vector<std::unique_ptr<dfa>> idle;
 };
 
-struct ctx
-{
-    env & environment;
-    bool once;
+// Test runner:
 
-    ctx( env & environment_, text proposition_ )
-    : environment( environment_), once( true )
+#if lest_FEATURE_REGEX_SEARCH
+    inline bool search( text re, text line )
     {
-        environment.push( proposition_);
+#if lest_FEATURE_LINEAR_REGEX
+        try
+        {
+            return linear_regex( re, false ).search( line );
+        }
+        catch ( regex_unsupported const & ) {}
+#endif
+        return std::regex_search( line, std::regex( re ) );
+    }
+#else
+    inline bool search( text part, text line )
+    {
+        return find_text( line.data(), line.size(), part.data(), part.size(), true ) != line.size();
     }
+#endif
 
-    ~ctx()
+inline bool match( texts whats, text line )
+{
+    for ( auto & what : whats )
     {
-#if lest_CPP17_OR_GREATER
-        if ( std::uncaught_exceptions() == 0 )
+        if ( search( what, line ) )
+            return true;
+    }
+    return false;
+}
+
+inline bool select( text name, texts include )
+{
+    auto none = []( texts args ) { return args.size() == 0; };
+
+#if lest_FEATURE_REGEX_SEARCH
+    auto hidden = []( text arg ){ return match( { "\\[\\..*", "\\[hide\\]" }, arg ); };
 #else
-        if ( ! std::uncaught_exception() )
+    auto hidden = []( text arg ){ return match( { "[.", "[hide]" }, arg ); };
 #endif
+
+    if ( none( include ) )
+    {
+        return ! hidden( name );
+    }
+
+    bool any = false;
+    for ( auto pos = include.rbegin(); pos != include.rend(); ++pos )
+    {
+        auto & part = *pos;
+
+        if ( part == "@" || part == "*" )
+            return true;
+
+        if ( search( part, name ) )
+            return true;
+
+        if ( '!' == part[0] )
         {
-            environment.pop();
+            any = true;
+            if ( search( part.substr(1), name ) )
+                return false;
+        }
+        else
+        {
+            any = false;
         }
     }
+    return any && ! hidden( name );
+}
+
+inline int indefinite( int repeat ) { return repeat == -1; }
+
+using seed_t = std::mt19937::result_type;
+
+struct options
+{
+    bool help    = false;
+    bool abort   = false;
+    bool count   = false;
+    bool list    = false;
+    bool tags    = false;
+    bool time    = false;
+    bool pass    = false;
+    bool zen     = false;
+    bool lexical = false;
+    bool random  = false;
+    bool verbose = false;
+    bool version = false;
+    int  repeat  = 1;
+    seed_t seed  = 0;
+    std::size_t max_elements = lest_FEATURE_MAX_ELEMENTS;
+    int  jobs    = 1;
+    int  fork_jobs = 0;
+    int  shard_index = 0;
+    int  shard_count = 1;
+    text coordinator = text();
+    text worker = text();
+    int  idle_timeout = 60;
+    text timing_db = text();
+    bool longest = false;
+    text results = text();
+    bool rerun_failed = false;
+    bool failed_first = false;
+};
+
+// apply the string limits of the options on the current thread during a run:
+
+struct limits_scope
+{
+    const string_limits saved;
+
+    limits_scope( options option ) : saved( to_string_limits() )
+    {
+        to_string_limits().max_elements = option.max_elements;
+    }
+
+    ~limits_scope()
+    {
+        to_string_limits() = saved;
+    }
+};
+
+struct env
+{
+    std::ostream & os;
+    options opt;
+    text testing;
+    std::vector< text > ctx;
+
+    env( std::ostream & out, options option )
+    : os( out ), opt( option ), testing(), ctx() {}
+
+    env & operator()( text test )
+    {
+        clear(); testing = test; return *this;
+    }
+
+    bool abort() { return opt.abort; }
+    bool pass()  { return opt.pass; }
+    bool zen()   { return opt.zen; }
+
+    void clear() { ctx.clear(); }
+    void pop()   { ctx.pop_back(); }
+    void push( text proposition ) { ctx.emplace_back( proposition ); }
+
+    text context() { return testing + sections(); }
+
+    text sections()
+    {
+        if ( ! opt.verbose )
+            return "";
+
+        text msg;
+        for( auto section : ctx )
+        {
+            msg += "\n  " + section;
+        }
+        return msg;
+    }
+};
+
+struct ctx
+{
+    env & environment;
+    bool once;
+
+    ctx( env & environment_, text proposition_ )
+    : environment( environment_), once( true )
+    {
+        environment.push( proposition_);
+    }
+
+    ~ctx()
+    {
+#if lest_CPP17_OR_GREATER
+        if ( std::uncaught_exceptions() == 0 )
+#else
+        if ( ! std::uncaught_exception() )
+#endif
+        {
+            environment.pop();
+        }
+    }
+
+    explicit operator bool() { bool result = once; once = false; return result; }
+};
+
+struct action
+{
+    std::ostream & os;
+
+    action( std::ostream & out ) : os( out ) {}
+
+    action( action const & ) = delete;
+    void operator=( action const & ) = delete;
+
+    operator      int() { return 0; }
+    bool        abort() { return false; }
+    action & operator()( test ) { return *this; }
+};
+
+struct print : action
+{
+    print( std::ostream & out ) : action( out ) {}
+
+    print & operator()( test testing )
+    {
+        os << testing.name << "\n"; return *this;
+    }
+};
+
+inline texts tags( text name, texts result = {} )
+{
+    auto none = std::string::npos;
+    auto lb   = name.find_first_of( "[" );
+    auto rb   = name.find_first_of( "]" );
+
+    if ( lb == none || rb == none )
+        return result;
+
+    result.emplace_back( name.substr( lb, rb - lb + 1 ) );
+
+    return tags( name.substr( rb + 1 ), result );
+}
+
+struct ptags : action
+{
+    std::set<text> result;
+
+    ptags( std::ostream & out ) : action( out ), result() {}
+
+    ptags & operator()( test testing )
+    {
+        for ( auto & tag : tags( testing.name ) )
+            result.insert( tag );
+
+        return *this;
+    }
+
+    ~ptags()
+    {
+        std::copy( result.begin(), result.end(), std::ostream_iterator<text>( os, "\n" ) );
+    }
+};
+
+struct count : action
+{
+    int n = 0;
+
+    count( std::ostream & out ) : action( out ) {}
+
+    count & operator()( test ) { ++n; return *this; }
+
+    ~count()
+    {
+        os << n << " selected " << pluralise("test", n) << "\n";
+    }
+};
+
+struct timer
+{
+    using time = std::chrono::high_resolution_clock;
+
+    time::time_point start = time::now();
+
+    double elapsed_seconds() const
+    {
+        return 1e-6 * static_cast<double>( std::chrono::duration_cast< std::chrono::microseconds >( time::now() - start ).count() );
+    }
+};
+
+// durations of tests in seconds, kept across runs in the file of option
+// timing_db as lines "seconds name"; a new measurement moves the recorded
+// duration a third of the way towards it, so a single slow run of a test
+// does not upset the order:
+
+using durations = std::map<text, double>;
+
+inline durations load_timings( text const & path )
+{
+    durations result;
+    std::ifstream in( path );
+
+    double seconds = 0; text name;
+    while ( in >> seconds && in.get() == ' ' && std::getline( in, name ) )
+        result[ name ] = seconds;
+
+    return result;
+}
+
+inline void save_timings( std::ostream & os, options option, durations const & measured )
+{
+    if ( option.timing_db.empty() || measured.empty() )
+        return;
+
+    const double weight = 1.0 / 3;
+    durations recorded = load_timings( option.timing_db );
+
+    for ( auto & m : measured )
+    {
+        auto pos = recorded.find( m.first );
+
+        if ( pos == recorded.end() ) recorded.insert( m );
+        else                         pos->second += weight * ( m.second - pos->second );
+    }
+
+    std::ofstream out( option.timing_db );
+    out << std::setprecision( 6 );
+
+    for ( auto & r : recorded )
+        out << r.second << ' ' << r.first << '\n';
+
+    if ( ! out.flush() )
+        os << "Error: cannot write timing database '" << option.timing_db << "'\n";
+}
+
+// outcome of each test run, kept in the file of option.results as lines
+// "passed seconds name" or "failed seconds name"; a run replaces the lines
+// of the tests it ran and keeps the others:
+
+struct verdict
+{
+    bool failed;
+    double seconds;
+};
+
+using verdicts = std::map<text, verdict>;
+
+inline verdicts load_results( text const & path )
+{
+    verdicts result;
+    std::ifstream in( path );
+
+    text status, name; double seconds = 0;
+    while ( in >> status >> seconds && in.get() == ' ' && std::getline( in, name ) )
+        result[ name ] = verdict{ status == "failed", seconds };
+
+    return result;
+}
+
+inline void save_results( std::ostream & os, options option, verdicts const & recent )
+{
+    if ( option.results.empty() || recent.empty() )
+        return;
+
+    verdicts recorded = load_results( option.results );
+
+    for ( auto & r : recent )
+        recorded[ r.first ] = r.second;
+
+    std::ofstream out( option.results );
+    out << std::setprecision( 6 );
+
+    for ( auto & r : recorded )
+        out << ( r.second.failed ? "failed " : "passed " ) << r.second.seconds << ' ' << r.first << '\n';
+
+    if ( ! out.flush() )
+        os << "Error: cannot write results file '" << option.results << "'\n";
+}
+
+struct times : action
+{
+    env output;
+    int selected = 0;
+    int failures = 0;
+
+    timer total;
+    durations measured;
+
+    times( std::ostream & out, options option )
+    : action( out ), output( out, option ), total(), measured()
+    {
+        os << std::setfill(' ') << std::fixed << std::setprecision( lest_FEATURE_TIME_PRECISION );
+    }
+
+    operator int() { return failures; }
+
+    bool abort() { return output.abort() && failures > 0; }
+
+    times & operator()( test testing )
+    {
+        timer t;
+
+        try
+        {
+            testing.behaviour( output( testing.name ) );
+        }
+        catch( message const & )
+        {
+            ++failures;
+        }
+
+        const double seconds = t.elapsed_seconds();
+
+        os << std::setw(3) << ( 1000 * seconds ) << " ms: " << testing.name  << "\n";
+
+        if ( ! output.opt.timing_db.empty() )
+            measured[ testing.name ] = seconds;
+
+        return *this;
+    }
+
+    ~times()
+    {
+        os << "Elapsed time: " << std::setprecision(1) << total.elapsed_seconds() << " s\n";
+
+        save_timings( os, output.opt, measured );
+    }
+};
+
+struct confirm : action
+{
+    env output;
+    int selected = 0;
+    int failures = 0;
+
+    durations measured;
+    verdicts recent;
+
+    confirm( std::ostream & out, options option )
+    : action( out ), output( out, option ), measured(), recent() {}
+
+    operator int() { return failures; }
+
+    bool abort() { return output.abort() && failures > 0; }
+
+    // a negative duration means that it is unknown, e.g. after a crash:
+
+    void record( text const & name, bool failed, double seconds )
+    {
+        if ( ! output.opt.timing_db.empty() && seconds >= 0 )
+            measured[ name ] = seconds;
+
+        if ( ! output.opt.results.empty() )
+            recent[ name ] = verdict{ failed, (std::max)( 0.0, seconds ) };
+    }
+
+    confirm & operator()( test testing )
+    {
+        timer t;
+        bool failed = false;
+
+        try
+        {
+            ++selected; testing.behaviour( output( testing.name ) );
+        }
+        catch( message const & e )
+        {
+            ++failures; failed = true; report( os, e, output.context() );
+        }
+
+        record( testing.name, failed, t.elapsed_seconds() );
+
+        return *this;
+    }
+
+    ~confirm()
+    {
+        save_timings( os, output.opt, measured );
+        save_results( os, output.opt, recent );
+
+        if ( failures > 0 )
+        {
+            os << failures << " out of " << selected << " selected " << pluralise("test", selected) << " " << colourise( "failed.\n" );
+        }
+        else if ( output.pass() )
+        {
+            os << "All " << selected << " selected " << pluralise("test", selected) << " " << colourise( "passed.\n" );
+        }
+    }
+};
+
+template< typename Action >
+bool abort( Action & perform )
+{
+    return perform.abort();
+}
+
+template< typename Action >
+Action && for_test( tests specification, texts in, Action && perform, int n = 1 )
+{
+    for ( int i = 0; indefinite( n ) || i < n; ++i )
+    {
+        for ( auto & testing : specification )
+        {
+            if ( select( testing.name, in ) )
+                if ( abort( perform( testing ) ) )
+                    return std::move( perform );
+        }
+    }
+    return std::move( perform );
+}
+
+// the report and result of a test that ran in a worker thread or process:
+
+struct outcome
+{
+    text report;
+    bool failed;
+    bool done;
+    double seconds;
+    std::exception_ptr error;
+
+    outcome() : report(), failed( false ), done( false ), seconds( -1 ), error() {}
+};
+
+#if lest_FEATURE_JOBS
+
+// run selected tests on option.jobs threads that take the next test in turn;
+// each worker has its own env and report buffer, and the main thread emits
+// the reports in test order:
+
+class workers
+{
+public:
+    workers( tests const & batch_, options option_ )
+    : batch( batch_), option( option_), outcomes( batch_.size() ), next( 0 ), stop( false ), mutex(), finished(), threads()
+    {
+        const std::size_t n = (std::min)( static_cast<std::size_t>( option.jobs ), batch.size() );
+
+        for ( std::size_t i = 0; i < n; ++i )
+            threads.emplace_back( [this]{ work(); } );
+    }
+
+    ~workers()
+    {
+        stop = true;
+
+        for ( auto & thread : threads )
+            thread.join();
+    }
+
+    outcome result( std::size_t i )
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        finished.wait( lock, [&]{ return outcomes[i].done; } );
+        return std::move( outcomes[i] );
+    }
+
+private:
+    void work()
+    {
+        limits_scope limits( option );
+        std::ostringstream buffer;
+        env output( buffer, option );
+
+        while ( ! stop )
+        {
+            const std::size_t i = next++;
+
+            if ( i >= batch.size() )
+                return;
+
+            outcome done;
+            timer t;
+            try
+            {
+                batch[i].behaviour( output( batch[i].name ) );
+            }
+            catch( message const & e )
+            {
+                done.failed = true; report( buffer, e, output.context() );
+            }
+            catch(...)
+            {
+                done.error = std::current_exception();
+            }
+
+            done.report = buffer.str(); buffer.str( "" );
+            done.seconds = t.elapsed_seconds();
+            done.done = true;
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                outcomes[i] = std::move( done );
+            }
+            finished.notify_all();
+        }
+    }
+
+    tests const & batch;
+    const options option;
+    std::vector<outcome> outcomes;
+    std::atomic<std::size_t> next;
+    std::atomic<bool> stop;
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<std::thread> threads;
+};
+
+#endif // lest_FEATURE_JOBS
+
+#if lest_FEATURE_FORK || lest_FEATURE_COORDINATOR
+
+// worker processes send the result of a test as status, duration, report size
+// and report:
+
+enum test_status : char { test_passed, test_failed, test_error };
+
+inline bool write_all( int fd, void const * data, std::size_t size )
+{
+    for ( auto pos = static_cast<char const *>( data ); size > 0; )
+    {
+        const auto n = ::write( fd, pos, size );
+        if ( n <= 0 )
+            return false;
+        pos += n; size -= static_cast<std::size_t>( n );
+    }
+    return true;
+}
+
+inline bool read_all( int fd, void * data, std::size_t size )
+{
+    for ( auto pos = static_cast<char *>( data ); size > 0; )
+    {
+        const auto n = ::read( fd, pos, size );
+        if ( n <= 0 )
+            return false;
+        pos += n; size -= static_cast<std::size_t>( n );
+    }
+    return true;
+}
+
+inline test_status execute( test const & testing, env & output, std::ostringstream & buffer )
+{
+    try
+    {
+        testing.behaviour( output( testing.name ) );
+        return test_passed;
+    }
+    catch( message const & e )
+    {
+        report( buffer, e, output.context() );
+        return test_failed;
+    }
+    catch( std::exception const & e )
+    {
+        buffer << e.what();
+        return test_error;
+    }
+    catch(...)
+    {
+        buffer << "unknown exception";
+        return test_error;
+    }
+}
+
+inline bool send_result( int fd, test_status state, double seconds, text const & report_text )
+{
+    const std::uint64_t size = report_text.size();
+
+    return write_all( fd, &state, sizeof state ) && write_all( fd, &seconds, sizeof seconds )
+        && write_all( fd, &size, sizeof size ) && write_all( fd, report_text.data(), report_text.size() );
+}
+
+// false if the worker went away before its result was complete:
+
+inline bool receive_result( int fd, outcome & done )
+{
+    test_status state = test_passed;
+    double seconds = 0;
+    std::uint64_t size = 0;
+
+    if ( ! read_all( fd, &state, sizeof state ) || ! read_all( fd, &seconds, sizeof seconds ) || ! read_all( fd, &size, sizeof size ) )
+        return false;
+
+    done.report.resize( static_cast<std::size_t>( size ) );
+
+    if ( size > 0 && ! read_all( fd, &done.report[0], done.report.size() ) )
+        return false;
+
+    done.failed  = state != test_passed;
+    done.seconds = seconds;
+    done.done    = true;
+
+    if ( state == test_error )
+    {
+        done.error = std::make_exception_ptr( std::runtime_error( done.report ) );
+        done.report.clear();
+    }
+    return true;
+}
+
+// a worker ends with _exit(), so it must flush what its tests print itself:
+
+inline void flush_output()
+{
+    std::cout.flush(); std::cerr.flush(); std::clog.flush();
+    std::fflush( nullptr );
+}
+
+// writing to a worker that has died must fail instead of raising SIGPIPE:
+
+class sigpipe_guard
+{
+public:
+    sigpipe_guard() : handler( std::signal( SIGPIPE, SIG_IGN ) ) {}
+    ~sigpipe_guard() { std::signal( SIGPIPE, handler ); }
+
+    sigpipe_guard( sigpipe_guard const & ) = delete;
+    sigpipe_guard & operator=( sigpipe_guard const & ) = delete;
+
+private:
+    void (*handler)( int );
+};
+
+#endif // lest_FEATURE_FORK || lest_FEATURE_COORDINATOR
+
+#if lest_FEATURE_FORK
+
+// run selected tests in option.fork_jobs worker processes that receive test
+// indices and return status and report over pipes; a worker that dies is
+// reported as a crash of its test and replaced:
+
+class processes
+{
+public:
+    processes( tests const & batch_, options option_ )
+    : batch( batch_), option( option_), outcomes( batch_.size() ), pool(), next( 0 ), sigpipe()
+    {
+        pool.resize( (std::min)( static_cast<std::size_t>( option.fork_jobs ), batch.size() ) );
+    }
+
+    ~processes()
+    {
+        for ( auto & worker : pool )
+        {
+            if ( worker.busy )
+                ::kill( worker.pid, SIGKILL );
+            stop( worker );
+        }
+    }
+
+    outcome result( std::size_t i )
+    {
+        while ( ! outcomes[i].done )
+            pump();
+
+        return std::move( outcomes[i] );
+    }
+
+private:
+    struct worker
+    {
+        pid_t pid = -1;
+        int task = -1;
+        int result = -1;
+        bool busy = false;
+        std::size_t index = 0;
+    };
+
+    void start( worker & w )
+    {
+        int task[2], result[2];
+
+        if ( ::pipe( task ) != 0 || ::pipe( result ) != 0 )
+            throw std::runtime_error( "cannot create pipe for worker process" );
+
+        flush_output();
+
+        const pid_t pid = ::fork();
+
+        if ( pid < 0 )
+            throw std::runtime_error( "cannot fork worker process" );
+
+        if ( pid == 0 )
+        {
+            for ( auto & other : pool )
+            {
+                if ( other.task   >= 0 ) ::close( other.task   );
+                if ( other.result >= 0 ) ::close( other.result );
+            }
+            ::close( task[1] ); ::close( result[0] );
+            serve( task[0], result[1] );
+            ::_exit( 0 );
+        }
+
+        ::close( task[0] ); ::close( result[1] );
+
+        w.pid = pid; w.task = task[1]; w.result = result[0]; w.busy = false;
+    }
+
+    // worker process: run the tests whose indices arrive until end of input:
+
+    void serve( int task, int result )
+    {
+        std::ostringstream buffer;
+        env output( buffer, option );
+        std::uint64_t index;
+
+        while ( read_all( task, &index, sizeof index ) )
+        {
+            timer t;
+            const test_status state = execute( batch[ index ], output, buffer );
+            const double seconds = t.elapsed_seconds();
+
+            flush_output();
+
+            const text report_text = buffer.str(); buffer.str( "" );
+
+            if ( ! send_result( result, state, seconds, report_text ) )
+                return;
+        }
+    }
+
+    void stop( worker & w )
+    {
+        if ( w.pid < 0 )
+            return;
+
+        ::close( w.task ); ::close( w.result );
+
+        int status = 0;
+        ::waitpid( w.pid, &status, 0 );
+
+        w = worker();
+    }
+
+    // hand out tests to idle workers, then collect the results that are ready:
+
+    void pump()
+    {
+        for ( auto & w : pool )
+        {
+            if ( w.busy || next >= batch.size() )
+                continue;
+
+            if ( w.pid < 0 )
+                start( w );
+
+            const std::uint64_t index = next;
+
+            if ( write_all( w.task, &index, sizeof index ) )
+            {
+                w.busy = true; w.index = next++;
+            }
+            else
+            {
+                stop( w );
+            }
+        }
+
+        std::vector<pollfd> fds;
+        for ( auto & w : pool )
+        {
+            if ( w.busy )
+                fds.push_back( pollfd{ w.result, POLLIN, 0 } );
+        }
+
+        if ( fds.empty() || ::poll( fds.data(), static_cast<nfds_t>( fds.size() ), -1 ) <= 0 )
+            return;
+
+        for ( auto & w : pool )
+        {
+            const auto ready = std::find_if( fds.begin(), fds.end(), [&]( pollfd const & fd ){ return fd.fd == w.result && fd.revents != 0; } );
+
+            if ( w.busy && ready != fds.end() )
+                collect( w );
+        }
+    }
+
+    void collect( worker & w )
+    {
+        outcome & done = outcomes[ w.index ];
+
+        w.busy = false;
+
+        if ( receive_result( w.result, done ) )
+            return;
+
+        // the worker died while running the test:
+
+        const pid_t pid = w.pid;
+        ::close( w.task ); ::close( w.result );
+
+        int status = 0;
+        ::waitpid( pid, &status, 0 );
+
+        std::ostringstream os;
+        os << batch[ w.index ].name << ": " << colourise( "crashed" ) << ": ";
+        if ( WIFSIGNALED( status ) ) os << "terminated by signal " << WTERMSIG( status );
+        else                         os << "exited with code " << WEXITSTATUS( status );
+        os << "\n";
+
+        done.report = os.str();
+        done.failed = true;
+        done.done   = true;
+
+        w = worker();
+    }
+
+    tests const & batch;
+    const options option;
+    std::vector<outcome> outcomes;
+    std::vector<worker> pool;
+    std::size_t next;
+    sigpipe_guard sigpipe;
+};
+
+#endif // lest_FEATURE_FORK
+
+#if lest_FEATURE_COORDINATOR
+
+// address of a local socket, given as unix:/path:
+
+inline sockaddr_un socket_address( text const & address )
+{
+    const text prefix = "unix:";
+    sockaddr_un result = sockaddr_un();
+    result.sun_family = AF_UNIX;
+
+    if ( address.compare( 0, prefix.size(), prefix ) != 0 || address.size() == prefix.size() )
+        throw std::runtime_error( "expecting address of the form 'unix:/path', got '" + address + "' (try option --help)" );
+
+    const text path = address.substr( prefix.size() );
+
+    if ( path.size() >= sizeof result.sun_path )
+        throw std::runtime_error( "socket path too long: '" + path + "'" );
+
+    std::copy( path.begin(), path.end(), result.sun_path );
+    return result;
+}
+
+inline bool write_text( int fd, text const & str )
+{
+    const std::uint64_t size = str.size();
+
+    return write_all( fd, &size, sizeof size ) && write_all( fd, str.data(), str.size() );
+}
+
+inline bool read_text( int fd, text & str )
+{
+    std::uint64_t size = 0;
+
+    if ( ! read_all( fd, &size, sizeof size ) )
+        return false;
+
+    str.resize( static_cast<std::size_t>( size ) );
+
+    return size == 0 || read_all( fd, &str[0], str.size() );
+}
+
+// run selected tests in the worker processes that connect to the socket of
+// option.coordinator: an idle worker receives the name of the next test and
+// the reporting options, and returns status and report; workers may join at
+// any time and a worker that disconnects while running a test is reported as
+// a crash of that test; when no worker is connected for option.idle_timeout
+// seconds, the tests not yet run are reported as failed:
+
+class coordinator
+{
+public:
+    coordinator( tests const & batch_, options option_ )
+    : batch( batch_), option( option_), outcomes( batch_.size() ), pool(), next( 0 ), path(), listener( -1 ), sigpipe(), idle()
+    , reporting( static_cast<char>( option.pass << 0 | option.zen << 1 | option.verbose << 2 ) )
+    {
+        const sockaddr_un address = socket_address( option.coordinator );
+        path = address.sun_path;
+
+        struct stat info;
+        if ( ::lstat( path.c_str(), &info ) == 0 && S_ISSOCK( info.st_mode ) )
+            ::unlink( path.c_str() );
+
+        listener = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+
+        if ( listener < 0
+            || ::bind( listener, reinterpret_cast<sockaddr const *>( &address ), sizeof address ) != 0
+            || ::listen( listener, SOMAXCONN ) != 0 )
+        {
+            if ( listener >= 0 )
+                ::close( listener );
+            throw std::runtime_error( "cannot listen on '" + option.coordinator + "'" );
+        }
+    }
+
+    ~coordinator()
+    {
+        for ( auto & w : pool )
+        {
+            if ( w.fd >= 0 )
+                ::close( w.fd );
+        }
+        ::close( listener );
+        ::unlink( path.c_str() );
+    }
+
+    coordinator( coordinator const & ) = delete;
+    coordinator & operator=( coordinator const & ) = delete;
+
+    outcome result( std::size_t i )
+    {
+        while ( ! outcomes[i].done )
+            pump();
+
+        return std::move( outcomes[i] );
+    }
+
+private:
+    struct worker
+    {
+        int fd;
+        bool busy;
+        std::size_t index;
+    };
+
+    // hand out tests to idle workers, then accept new workers and collect
+    // the results that are ready:
+
+    void pump()
+    {
+        for ( auto & w : pool )
+        {
+            if ( w.busy || next >= batch.size() )
+                continue;
+
+            if ( write_text( w.fd, batch[ next ].name ) && write_all( w.fd, &reporting, sizeof reporting ) )
+            {
+                w.busy = true; w.index = next++;
+            }
+            else
+            {
+                ::close( w.fd ); w.fd = -1;
+            }
+        }
+
+        pool.erase( std::remove_if( pool.begin(), pool.end(), []( worker const & w ){ return w.fd < 0; } ), pool.end() );
+
+        int wait = -1;
+
+        if ( ! pool.empty() || option.idle_timeout == 0 )
+        {
+            idle = timer();
+        }
+        else
+        {
+            const double left = option.idle_timeout - idle.elapsed_seconds();
 
-    explicit operator bool() { bool result = once; once = false; return result; }
-};
+            if ( left <= 0 )
+                return give_up();
 
-struct action
-{
-    std::ostream & os;
+            wait = static_cast<int>( std::ceil( 1000 * left ) );
+        }
 
-    action( std::ostream & out ) : os( out ) {}
+        std::vector<pollfd> fds( 1, pollfd{ listener, POLLIN, 0 } );
+        for ( auto & w : pool )
+            fds.push_back( pollfd{ w.fd, POLLIN, 0 } );
 
-    action( action const & ) = delete;
-    void operator=( action const & ) = delete;
+        if ( ::poll( fds.data(), static_cast<nfds_t>( fds.size() ), wait ) <= 0 )
+            return;
 
-    operator      int() { return 0; }
-    bool        abort() { return false; }
-    action & operator()( test ) { return *this; }
-};
+        for ( std::size_t k = 0; k < pool.size(); ++k )
+        {
+            if ( fds[ k + 1 ].revents != 0 )
+                collect( pool[k] );
+        }
 
-struct print : action
-{
-    print( std::ostream & out ) : action( out ) {}
+        if ( fds[0].revents != 0 )
+        {
+            const int fd = ::accept( listener, nullptr, nullptr );
 
-    print & operator()( test testing )
-    {
-        os << testing.name << "\n"; return *this;
+            if ( fd >= 0 )
+                pool.push_back( worker{ fd, false, 0 } );
+        }
     }
-};
 
-inline texts tags( text name, texts result = {} )
-{
-    auto none = std::string::npos;
-    auto lb   = name.find_first_of( "[" );
-    auto rb   = name.find_first_of( "]" );
+    void collect( worker & w )
+    {
+        if ( ! w.busy )
+        {
+            ::close( w.fd ); w.fd = -1;
+            return;
+        }
 
-    if ( lb == none || rb == none )
-        return result;
+        outcome & done = outcomes[ w.index ];
 
-    result.emplace_back( name.substr( lb, rb - lb + 1 ) );
+        w.busy = false;
 
-    return tags( name.substr( rb + 1 ), result );
-}
+        if ( receive_result( w.fd, done ) )
+            return;
 
-struct ptags : action
-{
-    std::set<text> result;
+        ::close( w.fd ); w.fd = -1;
 
-    ptags( std::ostream & out ) : action( out ), result() {}
+        done.report = batch[ w.index ].name + ": crashed: worker disconnected\n";
+        done.failed = true;
+        done.done   = true;
+    }
 
-    ptags & operator()( test testing )
+    void give_up()
     {
-        for ( auto & tag : tags( testing.name ) )
-            result.insert( tag );
+        for ( ; next < batch.size(); ++next )
+        {
+            outcome & done = outcomes[ next ];
 
-        return *this;
+            done.report = batch[ next ].name + ": not run: no worker connected for " + std::to_string( option.idle_timeout ) + " s\n";
+            done.failed = true;
+            done.done   = true;
+        }
     }
 
-    ~ptags()
-    {
-        std::copy( result.begin(), result.end(), std::ostream_iterator<text>( os, "\n" ) );
-    }
+    tests const & batch;
+    const options option;
+    std::vector<outcome> outcomes;
+    std::vector<worker> pool;
+    std::size_t next;
+    text path;
+    int listener;
+    sigpipe_guard sigpipe;
+    timer idle;
+    const char reporting;
 };
 
-struct count : action
-{
-    int n = 0;
-
-    count( std::ostream & out ) : action( out ) {}
+// workers find a test by its name, so the selected tests need unique names:
 
-    count & operator()( test ) { ++n; return *this; }
+inline void require_unique_names( tests const & specification, texts in )
+{
+    std::set<text> names;
 
-    ~count()
+    for ( auto & testing : specification )
     {
-        os << n << " selected " << pluralise("test", n) << "\n";
+        if ( select( testing.name, in ) && ! names.insert( testing.name ).second )
+            throw std::runtime_error( "option --coordinator needs unique test names, '" + testing.name + "' occurs more than once" );
     }
-};
+}
 
-struct timer
-{
-    using time = std::chrono::high_resolution_clock;
+// connect to the coordinator, waiting for it to start listening:
 
-    time::time_point start = time::now();
+inline int connect_coordinator( text const & address_text )
+{
+    const sockaddr_un address = socket_address( address_text );
 
-    double elapsed_seconds() const
+    for ( int attempt = 0; attempt < 500; ++attempt )
     {
-        return 1e-6 * static_cast<double>( std::chrono::duration_cast< std::chrono::microseconds >( time::now() - start ).count() );
+        const int fd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+
+        if ( fd < 0 )
+            break;
+
+        if ( ::connect( fd, reinterpret_cast<sockaddr const *>( &address ), sizeof address ) == 0 )
+            return fd;
+
+        ::close( fd );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
     }
-};
+    throw std::runtime_error( "cannot connect to '" + address_text + "'" );
+}
 
-struct times : action
+// worker process: run the tests named by the coordinator until it hangs up;
+// the reports go to the coordinator, the result is the number of failures:
+
+inline int serve_coordinator( tests const & specification, options option )
 {
-    env output;
-    int selected = 0;
+    sigpipe_guard sigpipe;
+    std::ostringstream buffer;
+    env output( buffer, option );
     int failures = 0;
 
-    timer total;
+    const int fd = connect_coordinator( option.worker );
 
-    times( std::ostream & out, options option )
-    : action( out ), output( out, option ), total()
-    {
-        os << std::setfill(' ') << std::fixed << std::setprecision( lest_FEATURE_TIME_PRECISION );
-    }
+    text name; char reporting = 0;
 
-    operator int() { return failures; }
+    while ( read_text( fd, name ) && read_all( fd, &reporting, sizeof reporting ) )
+    {
+        output.opt.pass    = ( reporting & 1 ) != 0;
+        output.opt.zen     = ( reporting & 2 ) != 0;
+        output.opt.verbose = ( reporting & 4 ) != 0;
 
-    bool abort() { return output.abort() && failures > 0; }
+        auto named = [&]( test const & testing ){ return testing.name == name; };
+        auto pos   = std::find_if( specification.begin(), specification.end(), named );
 
-    times & operator()( test testing )
-    {
+        test_status state = test_error;
         timer t;
 
-        try
-        {
-            testing.behaviour( output( testing.name ) );
-        }
-        catch( message const & )
-        {
-            ++failures;
-        }
+        if ( pos == specification.end() )
+            buffer << "worker has no test '" << name << "'";
+        else if ( std::find_if( std::next( pos ), specification.end(), named ) != specification.end() )
+            buffer << "worker has more than one test '" << name << "'";
+        else
+            state = execute( *pos, output, buffer );
 
-        os << std::setw(3) << ( 1000 * t.elapsed_seconds() ) << " ms: " << testing.name  << "\n";
+        const double seconds = t.elapsed_seconds();
 
-        return *this;
-    }
+        flush_output();
 
-    ~times()
-    {
-        os << "Elapsed time: " << std::setprecision(1) << total.elapsed_seconds() << " s\n";
+        failures += state != test_passed;
+
+        const text report_text = buffer.str(); buffer.str( "" );
+
+        if ( ! send_result( fd, state, seconds, report_text ) )
+            break;
     }
-};
 
-struct confirm : action
+    ::close( fd );
+    return failures;
+}
+
+#endif // lest_FEATURE_COORDINATOR
+
+template< typename Pool >
+bool for_test_parallel( tests const & batch, confirm & perform, options option )
 {
-    env output;
-    int selected = 0;
-    int failures = 0;
+    Pool pool( batch, option );
 
-    confirm( std::ostream & out, options option )
-    : action( out ), output( out, option ) {}
+    for ( std::size_t i = 0; i < batch.size(); ++i )
+    {
+        outcome done = pool.result( i );
 
-    operator int() { return failures; }
+        if ( done.error )
+            std::rethrow_exception( done.error );
 
-    bool abort() { return output.abort() && failures > 0; }
+        perform.os << done.report;
+        ++perform.selected;
+        perform.failures += done.failed;
 
-    confirm & operator()( test testing )
-    {
-        try
-        {
-            ++selected; testing.behaviour( output( testing.name ) );
-        }
-        catch( message const & e )
-        {
-            ++failures; report( os, e, output.context() );
-        }
-        return *this;
+        perform.record( batch[i].name, done.failed, done.seconds );
+
+        if ( abort( perform ) )
+            return true;
     }
+    return false;
+}
 
-    ~confirm()
+template< typename Pool >
+int run_parallel( tests specification, texts in, std::ostream & os, options option )
+{
+    tests selected;
+    for ( auto & testing : specification )
     {
-        if ( failures > 0 )
-        {
-            os << failures << " out of " << selected << " selected " << pluralise("test", selected) << " " << colourise( "failed.\n" );
-        }
-        else if ( output.pass() )
-        {
-            os << "All " << selected << " selected " << pluralise("test", selected) << " " << colourise( "passed.\n" );
-        }
+        if ( select( testing.name, in ) )
+            selected.push_back( testing );
     }
-};
 
-template< typename Action >
-bool abort( Action & perform )
-{
-    return perform.abort();
+    tests batch;
+    for ( int i = 0; i < ( indefinite( option.repeat ) ? 1 : option.repeat ); ++i )
+        batch.insert( batch.end(), selected.begin(), selected.end() );
+
+    confirm perform( os, option );
+
+    while ( ! for_test_parallel<Pool>( batch, perform, option ) && indefinite( option.repeat ) )
+        ;
+
+    return perform;
 }
 
-template< typename Action >
-Action && for_test( tests specification, texts in, Action && perform, int n = 1 )
+#if lest_FEATURE_COORDINATOR
+inline int run_coordinated( tests specification, texts in, std::ostream & os, options option )
 {
-    for ( int i = 0; indefinite( n ) || i < n; ++i )
-    {
-        for ( auto & testing : specification )
-        {
-            if ( select( testing.name, in ) )
-                if ( abort( perform( testing ) ) )
-                    return std::move( perform );
-        }
-    }
-    return std::move( perform );
+    require_unique_names( specification, in );
+
+    return run_parallel<coordinator>( specification, in, os, option );
 }
+#endif
 
 inline void sort( tests & specification )
 {
@@ -1286,6 +3190,68 @@ inline void shuffle( tests & specification, options option )
     std::shuffle( specification.begin(), specification.end(), std::mt19937( option.seed ) );
 }
 
+// put the tests with the longest recorded duration first; tests without a
+// recorded duration go before all others, as nothing bounds how long they take:
+
+inline void longest_first( tests & specification, options option )
+{
+    const durations recorded = load_timings( option.timing_db );
+
+    auto duration = [&]( test const & testing )
+    {
+        auto pos = recorded.find( testing.name );
+        return pos != recorded.end() ? pos->second : (std::numeric_limits<double>::max)();
+    };
+
+    std::stable_sort( specification.begin(), specification.end(), [&]( test const & a, test const & b ) { return duration( a ) > duration( b ); } );
+}
+
+// keep only the tests that failed when last run, or put them first:
+
+inline bool failed_before( test const & testing, verdicts const & recorded )
+{
+    auto pos = recorded.find( testing.name );
+    return pos != recorded.end() && pos->second.failed;
+}
+
+// without a results file to read, e.g. on the first run or with a mistyped
+// path, run the whole selection rather than nothing:
+
+inline void rerun_failed( tests & specification, options option )
+{
+    if ( ! std::ifstream( option.results ).is_open() )
+        return;
+
+    const verdicts recorded = load_results( option.results );
+
+    specification.erase( std::remove_if( specification.begin(), specification.end(),
+        [&]( test const & testing ) { return ! failed_before( testing, recorded ); } ), specification.end() );
+}
+
+inline void failed_first( tests & specification, options option )
+{
+    const verdicts recorded = load_results( option.results );
+
+    std::stable_partition( specification.begin(), specification.end(),
+        [&]( test const & testing ) { return failed_before( testing, recorded ); } );
+}
+
+// keep the selected tests of shard option.shard_index out of option.shard_count,
+// dealt round-robin in declaration order:
+
+inline tests shard( tests const & specification, texts in, options option )
+{
+    tests result;
+    int position = 0;
+
+    for ( auto & testing : specification )
+    {
+        if ( select( testing.name, in ) && position++ % option.shard_count == option.shard_index )
+            result.push_back( testing );
+    }
+    return result;
+}
+
 // workaround MinGW bug, http://stackoverflow.com/a/16132279:
 
 inline int stoi( text num )
@@ -1319,6 +3285,80 @@ inline int repeat( text opt, text arg )
     throw std::runtime_error( "expecting '-1' or positive number with option '" + opt + "', got '" + arg + "' (try option --help)" );
 }
 
+inline std::size_t max_elements( text opt, text arg )
+{
+    if ( ! arg.empty() && is_number( arg ) )
+        return static_cast<std::size_t>( std::strtoul( arg.c_str(), nullptr, 10 ) );
+
+    throw std::runtime_error( "expecting '0' or positive number with option '" + opt + "', got '" + arg + "' (try option --help)" );
+}
+
+inline int job_count( text opt, text arg )
+{
+    if ( arg.empty() || arg == "0" )
+        return (std::max)( 1, static_cast<int>( std::thread::hardware_concurrency() ) );
+
+    if ( is_number( arg ) )
+        return lest::stoi( arg );
+
+    throw std::runtime_error( "expecting '0' or positive number with option '" + opt + "', got '" + arg + "' (try option --help)" );
+}
+
+inline int jobs( text opt, text arg )
+{
+#if lest_FEATURE_JOBS
+    return job_count( opt, arg );
+#else
+    throw std::runtime_error( "option '" + opt + "' is not available, compile with lest_FEATURE_JOBS=1" );
+#endif
+}
+
+inline int fork_jobs( text opt, text arg )
+{
+#if lest_FEATURE_FORK
+    return job_count( opt, arg );
+#else
+    throw std::runtime_error( "option '" + opt + "' is not available on this platform" );
+#endif
+}
+
+inline text coordinator_address( text opt, text arg )
+{
+#if lest_FEATURE_COORDINATOR
+    (void) opt;
+    socket_address( arg );
+    return arg;
+#else
+    throw std::runtime_error( "option '" + opt + "' is not available on this platform" );
+#endif
+}
+
+inline int idle_timeout( text opt, text arg )
+{
+    if ( ! arg.empty() && is_number( arg ) )
+        return lest::stoi( arg );
+
+    throw std::runtime_error( "expecting '0' or positive number of seconds with option '" + opt + "', got '" + arg + "' (try option --help)" );
+}
+
+inline text file_name( text opt, text arg )
+{
+    if ( ! arg.empty() )
+        return arg;
+
+    throw std::runtime_error( "expecting file name with option '" + opt + "' (try option --help)" );
+}
+
+inline int shard_number( text opt, text arg, int minimum )
+{
+    const int num = lest::stoi( arg );
+
+    if ( ! arg.empty() && is_number( arg ) && num >= minimum )
+        return num;
+
+    throw std::runtime_error( "expecting " + std::string( minimum > 0 ? "positive" : "non-negative" ) + " number with option '" + opt + "', got '" + arg + "' (try option --help)" );
+}
+
 inline auto split_option( text arg ) -> std::tuple<text, text>
 {
     auto pos = arg.rfind( '=' );
@@ -1328,10 +3368,38 @@ inline auto split_option( text arg ) -> std::tuple<text, text>
                 : std::make_tuple( arg.substr( 0, pos ), arg.substr( pos + 1 ) );
 }
 
+// accept -j n and -jN for -j=n, as long as options are being read:
+
+inline texts join_short_values( texts const & args )
+{
+    texts result;
+
+    for ( std::size_t i = 0; i < args.size(); ++i )
+    {
+        text const & arg = args[i];
+
+        if ( arg.empty() || arg[0] != '-' || arg == "--" )
+        {
+            result.insert( result.end(), args.begin() + static_cast<std::ptrdiff_t>( i ), args.end() );
+            break;
+        }
+
+        if ( arg == "-j" && i + 1 < args.size() && ! args[i + 1].empty() && is_number( args[i + 1] ) )
+            result.push_back( arg + "=" + args[++i] );
+        else if ( arg.size() > 2 && arg.compare( 0, 2, "-j" ) == 0 && is_number( arg.substr( 2 ) ) )
+            result.push_back( "-j=" + arg.substr( 2 ) );
+        else
+            result.push_back( arg );
+    }
+    return result;
+}
+
 inline auto split_arguments( texts args ) -> std::tuple<options, texts>
 {
     options option; texts in;
 
+    args = join_short_values( args );
+
     bool in_options = true;
 
     for ( auto & arg : args )
@@ -1356,14 +3424,36 @@ inline auto split_arguments( texts args ) -> std::tuple<options, texts>
             else if ( opt == "--order" && "declared"     == val ) { /* by definition */   ; continue; }
             else if ( opt == "--order" && "lexical"      == val ) { option.lexical =  true; continue; }
             else if ( opt == "--order" && "random"       == val ) { option.random  =  true; continue; }
+            else if ( opt == "--order" && "longest-first" == val ) { option.longest =  true; continue; }
             else if ( opt == "--random-seed" ) { option.seed   = seed  ( "--random-seed", val ); continue; }
             else if ( opt == "--repeat"      ) { option.repeat = repeat( "--repeat"     , val ); continue; }
+            else if ( opt == "--max-elements" ) { option.max_elements = max_elements( "--max-elements", val ); continue; }
+            else if ( opt == "-j" || "--jobs" == opt ) { option.jobs = jobs( "--jobs", val ); continue; }
+            else if ( opt == "--fork-jobs" ) { option.fork_jobs = fork_jobs( "--fork-jobs", val ); continue; }
+            else if ( opt == "--shard-index" ) { option.shard_index = shard_number( "--shard-index", val, 0 ); continue; }
+            else if ( opt == "--shard-count" ) { option.shard_count = shard_number( "--shard-count", val, 1 ); continue; }
+            else if ( opt == "--coordinator" ) { option.coordinator = coordinator_address( "--coordinator", val ); continue; }
+            else if ( opt == "--timing-db"   ) { option.timing_db   = file_name( "--timing-db", val ); continue; }
+            else if ( opt == "--results"     ) { option.results     = file_name( "--results"  , val ); continue; }
+            else if ( opt == "--rerun-failed" ) { option.rerun_failed = true; continue; }
+            else if ( opt == "--failed-first" ) { option.failed_first = true; continue; }
+            else if ( opt == "--idle-timeout" ) { option.idle_timeout = idle_timeout( "--idle-timeout", val ); continue; }
+            else if ( opt == "--worker"      ) { option.worker      = coordinator_address( "--worker"     , val ); continue; }
             else throw std::runtime_error( "unrecognised option '" + arg + "' (try option --help)" );
         }
         in.push_back( arg );
     }
     option.pass = option.pass || option.zen;
 
+    if ( option.shard_index >= option.shard_count )
+        throw std::runtime_error( "expecting --shard-index less than --shard-count (try option --help)" );
+
+    if ( option.longest && option.timing_db.empty() )
+        throw std::runtime_error( "expecting option --timing-db with --order=longest-first (try option --help)" );
+
+    if ( ( option.rerun_failed || option.failed_first ) && option.results.empty() )
+        throw std::runtime_error( "expecting option --results with --rerun-failed and --failed-first (try option --help)" );
+
     return std::make_tuple( option, in );
 }
 
@@ -1385,9 +3475,22 @@ inline int usage( std::ostream & os )
         "  --order=declared   use source code test order (default)\n"
         "  --order=lexical    use lexical sort test order\n"
         "  --order=random     use random test order\n"
+        "  --order=longest-first  use longest recorded duration first (needs --timing-db)\n"
         "  --random-seed=n    use n for random generator seed\n"
         "  --random-seed=time use time for random generator seed\n"
         "  --repeat=n         repeat selected tests n times (-1: indefinite)\n"
+        "  --max-elements=n   report at most n elements of a container (0: all)\n"
+        "  -j, --jobs=n       run selected tests on n threads (0 or none: all cores), also -j n, -jn\n"
+        "  --fork-jobs=n      run selected tests in n worker processes (0 or none: all cores)\n"
+        "  --shard-index=i    run shard i of the selected tests, counting from 0\n"
+        "  --shard-count=n    deal the selected tests round-robin over n shards\n"
+        "  --timing-db=file   keep running average of test durations in file\n"
+        "  --results=file     record outcome of tests run in file\n"
+        "  --rerun-failed     run only the tests that failed in results file (all without file)\n"
+        "  --failed-first     run the tests that failed in results file first\n"
+        "  --coordinator=unix:/path  hand out selected tests to workers that connect to path\n"
+        "  --idle-timeout=s          fail tests not run when no worker is connected for s seconds (default 60, 0: wait)\n"
+        "  --worker=unix:/path       run the tests handed out by the coordinator at path\n"
         "  --version          report lest version and compiler used\n"
         "  --                 end options\n"
         "\n"
@@ -1435,8 +3538,16 @@ inline int run( tests specification, texts arguments, std::ostream & os = std::c
         options option; texts in;
         std::tie( option, in ) = split_arguments( arguments );
 
+        limits_scope limits( option );
+
+        if ( option.shard_count > 1 ) { specification = shard( specification, in, option ); }
+
         if ( option.lexical ) {    sort( specification         ); }
         if ( option.random  ) { shuffle( specification, option ); }
+        if ( option.longest ) { longest_first( specification, option ); }
+
+        if ( option.rerun_failed ) { rerun_failed( specification, option ); }
+        if ( option.failed_first ) { failed_first( specification, option ); }
 
         if ( option.help    ) { return usage   ( os ); }
         if ( option.version ) { return version ( os ); }
@@ -1445,6 +3556,17 @@ inline int run( tests specification, texts arguments, std::ostream & os = std::c
         if ( option.tags    ) { return for_test( specification, in, ptags( os ) ); }
         if ( option.time    ) { return for_test( specification, in, times( os, option ) ); }
 
+#if lest_FEATURE_COORDINATOR
+        if ( ! option.worker.empty()      ) { return serve_coordinator( specification, option ); }
+        if ( ! option.coordinator.empty() ) { return run_coordinated( specification, in, os, option ); }
+#endif
+#if lest_FEATURE_FORK
+        if ( option.fork_jobs > 0 ) { return run_parallel<processes>( specification, in, os, option ); }
+#endif
+#if lest_FEATURE_JOBS
+        if ( option.jobs > 1 ) { return run_parallel<workers>( specification, in, os, option ); }
+#endif
+
         return for_test( specification, in, confirm( os, option ), option.repeat );
     }
     catch ( std::exception const & e )
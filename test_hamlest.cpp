@@ -5,6 +5,14 @@
 
 #include "hamlest.hpp"
 
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <list>
+#include <numeric>
+#include <thread>
+#include <unordered_set>
+
 using lest::test;
 using namespace lest::hamlest;
 
@@ -16,6 +24,8 @@ char const *hello()       { return "hello"; }
 char const *world()       { return "world"; }
 char const *hello_world() { return "hello world"; }
 
+bool is_linear( std::string const & expr ) { return matches_regexp( expr, regex_engine::linear ).regex->is_linear(); }
+
 std::set<int> s{ 1, 2, 3, };
 std::set<int> t{ 2, 1, 0, };
 std::set<int> u;
@@ -97,6 +107,22 @@ const test specification[] =
         EXPECT( 1 == run( pass, os ) );
     },
 
+    CASE("expect_that evaluates the actual and the matcher expression only once")
+    {
+        int actual_count = 0, match_count = 0;
+
+        auto actual = [&]() { return ++actual_count; };
+        auto match  = [&]() { return ++match_count, equal_to( 0 ); };
+
+        test fail[] = {{ CASE_ON("F", &actual, &match) { EXPECT_THAT( actual(), match() ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+        EXPECT( 1 == actual_count );
+        EXPECT( 1 == match_count );
+    },
+
     // object:
     
     CASE("same_instance matches properly")
@@ -138,6 +164,518 @@ const test specification[] =
         EXPECT( false == equal_to(3)(4) );
     },
 
+    CASE("equal_to describes a mismatch of containers by their first differences")
+    {
+        std::vector<int> expected( 100000 );
+        for ( std::size_t i = 0; i < expected.size(); ++i )
+            expected[i] = static_cast<int>( i );
+
+        EXPECT(  true == equal_to( expected )( expected ) );
+        EXPECT( false == equal_to( expected )( std::vector<int>( expected.begin(), expected.end() - 1 ) ) );
+
+        auto actual = expected;
+        for ( std::size_t i = 500; i < actual.size(); i += 1000 )
+            actual[i] = -1;
+        actual.push_back( 7 );
+
+        test fail[] = {{ CASE("F") {
+            std::vector<int> expected( 100000 ); std::iota( expected.begin(), expected.end(), 0 );
+            auto actual = expected; actual[5] = -1; actual[3000] = -1; actual.resize( 99999 );
+            EXPECT_THAT( actual, equal_to( expected ) ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, { "--max-elements=20" }, os ) );
+        EXPECT( std::string::npos != os.str().find( "size 99999 instead of 100000; at index 5 -1 instead of 5 in { ..., [3] 3, [4] 4, [5] -1, [6] 6, [7] 7, ... }; at index 3000 -1 instead of 3000 in" ) );
+        EXPECT( std::string::npos != os.str().find( "{ 0, 1, 2, 3, 4, -1, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, ... (99979 more) }" ) );
+        EXPECT( os.str().size() < 2000u );
+
+        test fail_many[] = {{ CASE("F") {
+            std::vector<int> expected( 100000, 1 ), actual( 100000, 2 );
+            EXPECT_THAT( actual, is( expected ) ); } }};
+
+        std::ostringstream os_many;
+
+        EXPECT( 1 == run( fail_many, os_many ) );
+        EXPECT( std::string::npos != os_many.str().find( "at index 4 2 instead of 1 in { ..., [2] 2, [3] 2, [4] 2, [5] 2, [6] 2, ... }; 99995 more differing elements" ) );
+        EXPECT( os_many.str().size() < 2000u );
+
+        test fail_small[] = {{ CASE("F") { EXPECT_THAT( s, equal_to( t ) ); } }};
+
+        std::ostringstream os_small;
+
+        EXPECT( 1 == run( fail_small, os_small ) );
+        EXPECT( std::string::npos != os_small.str().find( "{ 1, 2, 3, } is equal to { 0, 1, 2, }: at index 0 1 instead of 0; at index 1 2 instead of 1; at index 2 3 instead of 2\n" ) );
+
+        test fail_all[] = {{ CASE("F") { EXPECT_THAT( std::vector<int>( 30, 1 ), equal_to( std::vector<int>( 30, 2 ) ) ); } }};
+
+        std::ostringstream os_default, os_limited, os_all;
+
+        EXPECT( 1 == run( fail_all, {}, os_default ) );
+        EXPECT( 1 == run( fail_all, { "--max-elements=10" }, os_limited ) );
+        EXPECT( 1 == run( fail_all, { "--max-elements=0" }, os_all ) );
+        EXPECT( std::string::npos == os_default.str().find( "more) }" ) );
+        EXPECT( std::string::npos != os_limited.str().find( "1, 1, ... (20 more) }" ) );
+        EXPECT( std::string::npos == os_all.str().find( "more) }" ) );
+        EXPECT( std::string::npos != os_all.str().find( "{ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, }" ) );
+
+        EXPECT_THAT( actual, is_not( equal_to( expected ) ) );
+    },
+
+    CASE("to_string elides container elements beyond the limit and nesting beyond the depth")
+    {
+        std::vector<int> v( 1000, 7 );
+        std::vector<std::vector<std::vector<std::vector<std::vector<int>>>>> nested{ { { { { 1 } } } } };
+
+        EXPECT( lest::to_string( std::vector<int>{ 1, 2 } ) == "{ 1, 2, }" );
+        EXPECT( lest::to_string( v ).size() < 500u );
+        EXPECT( std::string::npos != lest::to_string( v ).find( "7, 7, ... (900 more) }" ) );
+        EXPECT( lest::to_string( nested ) == "{ { { { { ... }, }, }, }, }" );
+
+        test fail[] = {{ CASE("F") { EXPECT( std::vector<int>( 1000, 7 ) == std::vector<int>( 1000, 8 ) ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, { "--max-elements=3" }, os ) );
+        EXPECT( std::string::npos != os.str().find( "{ 7, 7, 7, ... (997 more) } == { 8, 8, 8, ... (997 more) }" ) );
+        EXPECT( lest::to_string( v ).size() < 500u );
+
+        std::ostringstream os_all;
+
+        EXPECT( 1 == run( fail, { "--max-elements=0" }, os_all ) );
+        EXPECT( std::string::npos == os_all.str().find( "more" ) );
+#if lest_FEATURE_JOBS
+
+        std::ostringstream os_jobs;
+
+        EXPECT( 1 == run( fail, { "--max-elements=3", "--jobs=2" }, os_jobs ) );
+        EXPECT( std::string::npos != os_jobs.str().find( "{ 7, 7, 7, ... (997 more) } == { 8, 8, 8, ... (997 more) }" ) );
+#endif
+    },
+
+#if lest_FEATURE_JOBS
+    CASE("to_string limits of tests that run on several threads do not affect each other")
+    {
+        test nested[] = {
+            CASE("3") {
+                test fail[] = {{ CASE("F") { EXPECT( std::vector<int>( 1000, 7 ) == std::vector<int>( 1000, 8 ) ); } }};
+                std::ostringstream os;
+                EXPECT( 1 == run( fail, { "--max-elements=3" }, os ) );
+                EXPECT( std::string::npos != os.str().find( "{ 7, 7, 7, ... (997 more) }" ) ); },
+            CASE("5") {
+                test fail[] = {{ CASE("F") { EXPECT( std::vector<int>( 1000, 7 ) == std::vector<int>( 1000, 8 ) ); } }};
+                std::ostringstream os;
+                EXPECT( 1 == run( fail, { "--max-elements=5" }, os ) );
+                EXPECT( std::string::npos != os.str().find( "{ 7, 7, 7, 7, 7, ... (995 more) }" ) ); },
+        };
+
+        std::ostringstream os;
+
+        EXPECT( 0 == run( nested, { "--jobs=4", "--repeat=50" }, os ) );
+        EXPECT( lest::to_string_limits().max_elements == std::size_t( lest_FEATURE_MAX_ELEMENTS ) );
+    },
+#endif
+
+    CASE("to_string formats numbers as a stream does and escapes control characters")
+    {
+        EXPECT( lest::to_string( 0 ) == "0" );
+        EXPECT( lest::to_string( -2147483647 - 1 ) == "-2147483648" );
+        EXPECT( lest::to_string( 18446744073709551615ull ) == "18446744073709551615" );
+        EXPECT( lest::to_string( 3.14159265 ) == "3.14159" );
+        EXPECT( lest::to_string( 1e20 ) == "1e+20" );
+        EXPECT( lest::to_string( -2.5e-7 ) == "-2.5e-07" );
+        EXPECT( lest::to_string( 1.5f ) == "1.5" );
+
+        EXPECT( lest::to_string( std::string( "a\tb\x01\\" ) ) == "\"a\\tb\\x01\\\\\"" );
+        EXPECT( lest::to_string( "\r\n\f" ) == "\"\\r\\n\\f\"" );
+        EXPECT( lest::to_string( '\x1f' ) == "'\\x1f'" );
+        EXPECT( lest::to_string( 'x' ) == "'x'" );
+    },
+
+#if lest_FEATURE_JOBS
+    CASE("number of jobs is accepted as -j=n, -j n and -jn")
+    {
+        lest::options option; lest::texts in;
+
+        std::tie( option, in ) = lest::split_arguments( { "-j=3", "T" } );
+        EXPECT( option.jobs == 3 );
+
+        std::tie( option, in ) = lest::split_arguments( { "-j", "4", "-l", "T" } );
+        EXPECT( option.jobs == 4 );
+        EXPECT( option.list );
+        EXPECT( in == lest::texts{ "T" } );
+
+        std::tie( option, in ) = lest::split_arguments( { "-j5", "T" } );
+        EXPECT( option.jobs == 5 );
+        EXPECT( in == lest::texts{ "T" } );
+
+        std::tie( option, in ) = lest::split_arguments( { "-j", "T", "4" } );
+        EXPECT( option.jobs >= 1 );
+        EXPECT( in == ( lest::texts{ "T", "4" } ) );
+
+        std::tie( option, in ) = lest::split_arguments( { "--", "-j", "4" } );
+        EXPECT( option.jobs == 1 );
+        EXPECT( in == ( lest::texts{ "-j", "4" } ) );
+    },
+
+    CASE("tests run on several threads report in declaration order")
+    {
+        test spec[] = {
+            { CASE("T1") { std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) ); EXPECT( 1 == 1 ); } },
+            { CASE("T2") { EXPECT( 2 == 0 ); } },
+            { CASE("T3") { EXPECT( 3 == 3 ); } },
+            { CASE("T4") { EXPECT( 4 == 0 ); } },
+        };
+
+        std::ostringstream os, os_abort, os_repeat, os_seq;
+
+        EXPECT( 2 == run( spec, { "--jobs=3", "--pass" }, os ) );
+        EXPECT( 1 == run( spec, { "--jobs=3", "--abort" }, os_abort ) );
+        EXPECT( 6 == run( spec, { "-j", "--repeat=3" }, os_repeat ) );
+        EXPECT( 2 == run( spec, { "--pass" }, os_seq ) );
+
+        EXPECT( os.str() == os_seq.str() );
+        EXPECT( os.str().find( "T1: 1 == 1" ) < os.str().find( "T2: 2 == 0" ) );
+        EXPECT( std::string::npos == os_abort.str().find( "T4" ) );
+        EXPECT( std::string::npos != os_repeat.str().find( "6 out of 12 selected tests failed." ) );
+
+        test error[] = {{ CASE("E") { throw std::logic_error( "outside EXPECT" ); } }};
+
+        std::ostringstream os_error;
+
+        EXPECT( 1 == run( error, { "--jobs=2" }, os_error ) );
+        EXPECT( std::string::npos != os_error.str().find( "Error: outside EXPECT" ) );
+    },
+#else
+    CASE("option --jobs is refused without lest_FEATURE_JOBS")
+    {
+        test spec[] = {{ CASE("T") { EXPECT( 1 == 1 ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( spec, { "--jobs=2" }, os ) );
+        EXPECT( std::string::npos != os.str().find( "Error: option '--jobs' is not available" ) );
+    },
+#endif
+
+#if lest_FEATURE_FORK
+    CASE("tests run in worker processes keep what they print to std::cout")
+    {
+        // each test sends file descriptor 1 of its own worker process to a
+        // file, so that the output of other tests of this suite is not caught:
+
+        test spec[] = {
+            { CASE("P") { ::dup2( ::fileno( std::fopen( "lest-test-printed.txt", "a" ) ), 1 ); std::cout << "printed by P\n"; } },
+            { CASE("Q") { ::dup2( ::fileno( std::fopen( "lest-test-printed.txt", "a" ) ), 1 ); std::cout << "printed by Q\n"; } },
+        };
+
+        std::remove( "lest-test-printed.txt" );
+
+        std::ostringstream os;
+        const int failures = run( spec, { "--fork-jobs=1" }, os );
+
+        std::ifstream in( "lest-test-printed.txt" );
+        const std::string printed( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+        in.close();
+        std::remove( "lest-test-printed.txt" );
+
+        EXPECT( 0 == failures );
+        EXPECT( printed == "printed by P\nprinted by Q\n" );
+    },
+
+    CASE("tests run in worker processes survive crashing tests")
+    {
+        test spec[] = {
+            { CASE("T1") { EXPECT( 1 == 1 ); } },
+            { CASE("T2") { std::abort(); } },
+            { CASE("T3") { EXPECT( 3 == 0 ); } },
+            { CASE("T4") { std::_Exit( 3 ); } },
+            { CASE("T5") { EXPECT( 5 == 5 ); } },
+        };
+
+        std::ostringstream os, os_abort;
+
+        EXPECT( 3 == run( spec, { "--fork-jobs=2", "--pass" }, os ) );
+        EXPECT( 1 == run( spec, { "--fork-jobs=2", "--abort" }, os_abort ) );
+
+        EXPECT( std::string::npos != os.str().find( "T1: 1 == 1" ) );
+        EXPECT( std::string::npos != os.str().find( "T2: crashed: terminated by signal " + std::to_string( SIGABRT ) ) );
+        EXPECT( std::string::npos != os.str().find( "T3: 3 == 0" ) );
+        EXPECT( std::string::npos != os.str().find( "T4: crashed: exited with code 3" ) );
+        EXPECT( std::string::npos != os.str().find( "T5: 5 == 5" ) );
+        EXPECT( std::string::npos != os.str().find( "3 out of 5 selected tests failed." ) );
+        EXPECT( std::string::npos == os_abort.str().find( "T3" ) );
+
+        test error[] = {{ CASE("E") { throw std::logic_error( "outside EXPECT" ); } }};
+
+        std::ostringstream os_error;
+
+        EXPECT( 1 == run( error, { "--fork-jobs=2" }, os_error ) );
+        EXPECT( std::string::npos != os_error.str().find( "Error: outside EXPECT" ) );
+    },
+#endif
+
+#if lest_FEATURE_COORDINATOR
+    CASE("tests handed out by a coordinator run in the workers that connect to it")
+    {
+        test spec[] = {
+            { CASE("T1") { EXPECT( 1 == 1 ); } },
+            { CASE("T2") { EXPECT( 2 == 0 ); } },
+            { CASE("T3") { std::_Exit( 3 ); } },
+            { CASE("T4") { EXPECT( 4 == 4 ); } },
+            { CASE("U5") { EXPECT( 5 == 0 ); } },
+        };
+
+        const std::string address = "unix:/tmp/lest-test-" + std::to_string( ::getpid() ) + ".sock";
+
+        std::vector<pid_t> workers;
+        for ( int i = 0; i < 2; ++i )
+        {
+            const pid_t pid = ::fork();
+
+            if ( pid == 0 )
+            {
+                std::ostringstream sink;
+                std::_Exit( run( spec, { "--worker=" + address }, sink ) );
+            }
+            workers.push_back( pid );
+        }
+
+        std::ostringstream os;
+
+        EXPECT( 2 == run( spec, { "--coordinator=" + address, "--pass", "T" }, os ) );
+
+        for ( auto pid : workers )
+            ::waitpid( pid, nullptr, 0 );
+
+        EXPECT( os.str().find( "T1: 1 == 1" ) < os.str().find( "T2: 2 == 0" ) );
+        EXPECT( std::string::npos != os.str().find( "T3: crashed: worker disconnected" ) );
+        EXPECT( std::string::npos != os.str().find( "T4: 4 == 4" ) );
+        EXPECT( std::string::npos == os.str().find( "U5" ) );
+        EXPECT( std::string::npos != os.str().find( "2 out of 4 selected tests failed." ) );
+
+        test twins[] = {
+            { CASE("D") { EXPECT( 1 == 1 ); } },
+            { CASE("D") { EXPECT( 2 == 0 ); } },
+        };
+
+        std::ostringstream twins_all, twins_shard;
+
+        EXPECT( 1 == run( twins, { "--coordinator=" + address }, twins_all ) );
+        EXPECT( std::string::npos != twins_all.str().find( "Error: option --coordinator needs unique test names, 'D' occurs more than once" ) );
+
+        const pid_t twin_worker = ::fork();
+
+        if ( twin_worker == 0 )
+        {
+            std::ostringstream sink;
+            std::_Exit( run( twins, { "--worker=" + address }, sink ) );
+        }
+
+        EXPECT( 1 == run( twins, { "--coordinator=" + address, "--shard-count=2", "--shard-index=1" }, twins_shard ) );
+        ::waitpid( twin_worker, nullptr, 0 );
+        EXPECT( std::string::npos != twins_shard.str().find( "Error: worker has more than one test 'D'" ) );
+
+        std::ostringstream alone;
+
+        EXPECT( 4 == run( spec, { "--coordinator=" + address, "--idle-timeout=1", "T" }, alone ) );
+        EXPECT( std::string::npos != alone.str().find( "T1: not run: no worker connected for 1 s" ) );
+        EXPECT( std::string::npos != alone.str().find( "T4: not run: no worker connected for 1 s" ) );
+
+        std::ostringstream error;
+
+        EXPECT( 1 == run( spec, { "--worker=tcp:localhost" }, error ) );
+        EXPECT( std::string::npos != error.str().find( "Error: expecting address of the form 'unix:/path'" ) );
+    },
+#endif
+
+    CASE("tests are ordered longest-first by the durations recorded in the timing database")
+    {
+        test spec[] = {
+            { CASE("T1") { EXPECT( 1 == 1 ); } },
+            { CASE("T2") { EXPECT( 2 == 0 ); } },
+            { CASE("T3") { EXPECT( 3 == 3 ); } },
+            { CASE("T4") { EXPECT( 4 == 4 ); } },
+        };
+
+        const std::string db = "lest-test-timing.txt";
+        {
+            std::ofstream out( db );
+            out << "0.5 T1\n3 T3\n1 T4\n2 gone\n";
+        }
+
+        std::ostringstream list;
+
+        EXPECT( 0 == run( spec, { "--order=longest-first", "--timing-db=" + db, "--list-tests" }, list ) );
+        EXPECT( list.str() == "T2\nT3\nT4\nT1\n" );
+
+        std::ostringstream os;
+
+#if lest_FEATURE_JOBS
+        EXPECT( 1 == run( spec, { "--timing-db=" + db, "--jobs=2" }, os ) );
+#else
+        EXPECT( 1 == run( spec, { "--timing-db=" + db }, os ) );
+#endif
+
+        const lest::durations recorded = lest::load_timings( db );
+        std::remove( db.c_str() );
+
+        EXPECT( recorded.size() == 5u );
+        EXPECT( recorded.count( "T2" ) == 1u );
+        EXPECT( recorded.at( "gone" ) == 2.0 );
+        EXPECT( recorded.at( "T3" ) > 1.9 );
+        EXPECT( recorded.at( "T3" ) <= 2.0 );
+
+        std::ostringstream error;
+
+        EXPECT( 1 == run( spec, { "--order=longest-first" }, error ) );
+        EXPECT( std::string::npos != error.str().find( "Error: expecting option --timing-db" ) );
+    },
+
+    CASE("tests that failed in the results file are rerun or run first")
+    {
+        test spec[] = {
+            { CASE("T1") { EXPECT( 1 == 1 ); } },
+            { CASE("T2") { EXPECT( 2 == 0 ); } },
+            { CASE("T3") { EXPECT( 3 == 3 ); } },
+            { CASE("T4") { EXPECT( 4 == 0 ); } },
+        };
+
+        const std::string results = "lest-test-results.txt";
+        std::remove( results.c_str() );
+
+        std::ostringstream os, rerun, first;
+
+        EXPECT( 2 == run( spec, { "--results=" + results, "--rerun-failed" }, os ) );
+        EXPECT( std::string::npos != os.str().find( "2 out of 4 selected tests failed." ) );
+        EXPECT( 2 == run( spec, { "--results=" + results, "--rerun-failed", "--pass" }, rerun ) );
+        EXPECT( 0 == run( spec, { "--results=" + results, "--failed-first", "--list-tests" }, first ) );
+
+        const lest::verdicts recorded = lest::load_results( results );
+        std::remove( results.c_str() );
+
+        EXPECT( recorded.size() == 4u );
+        EXPECT( recorded.at( "T2" ).failed );
+        EXPECT( ! recorded.at( "T3" ).failed );
+
+        EXPECT( std::string::npos == rerun.str().find( "T1" ) );
+        EXPECT( std::string::npos != rerun.str().find( "2 out of 2 selected tests failed." ) );
+        EXPECT( first.str() == "T2\nT4\nT1\nT3\n" );
+
+        std::ostringstream error;
+
+        EXPECT( 1 == run( spec, { "--rerun-failed" }, error ) );
+        EXPECT( std::string::npos != error.str().find( "Error: expecting option --results" ) );
+    },
+
+#if ! lest_FEATURE_REGEX_SEARCH
+    CASE("tests are selected by case-insensitive text across vector block boundaries")
+    {
+        // the part at every offset of names up to 70 characters crosses the
+        // 16- and 32-character blocks and their tails; the filler yields many
+        // candidates with a matching first and last character:
+
+        for ( std::size_t n = 5; n <= 70; ++n )
+        {
+            for ( std::size_t at = 0; at + 5 <= n; ++at )
+            {
+                std::string name;
+                while ( name.size() < n )
+                    name += "mHmH";
+                name.resize( n );
+
+                EXPECT( n == lest::find_text( name.data(), n, "mAtCh", 5, true ) );
+
+                name.replace( at, 5, "MaTcH" );
+
+                EXPECT( at == lest::find_text( name.data(), n, "mAtCh", 5, true  ) );
+                EXPECT( n  == lest::find_text( name.data(), n, "mAtCh", 5, false ) );
+#if lest_FEATURE_SIMD_SEARCH
+                EXPECT( at == lest::find_text_sse2( name.data(), n, "mAtCh", 5, true ) );
+#endif
+            }
+        }
+
+        test spec[] = {
+            { CASE("0123456789abcdeMaTcH") {} },
+            { CASE("0123456789abcdef0123456789abcdeMATCH") {} },
+            { CASE("0123456789abcdef0123456789abcdef012345678match") {} },
+            { CASE("0123456789abcdef0123456789abcdeMATC") {} },
+        };
+
+        std::ostringstream os;
+
+        EXPECT( 0 == run( spec, { "--list-tests", "mAtCh" }, os ) );
+        EXPECT( os.str() == "0123456789abcdeMaTcH\n0123456789abcdef0123456789abcdeMATCH\n0123456789abcdef0123456789abcdef012345678match\n" );
+    },
+#endif
+
+#if lest_FEATURE_REGEX_SEARCH && lest_FEATURE_LINEAR_REGEX
+    CASE("tests are selected by regular expression in linear time, other constructs via std::regex")
+    {
+        const std::string name( 40, 'a' );
+
+        EXPECT( ! lest::search( "^(a*)*b$", name ) );
+        EXPECT(   lest::search( "^(a*)*$" , name ) );
+        EXPECT(   lest::search( "(a)\\1"   , name ) );
+        EXPECT( ! lest::search( "(b)\\1"   , name ) );
+    },
+#endif
+
+    CASE("shards of the selected tests are disjoint and together cover the selection")
+    {
+        test spec[] = {
+            { CASE("T1") {} }, { CASE("T2") {} }, { CASE("U3") {} }, { CASE("T4") {} },
+            { CASE("T5") {} }, { CASE("U6") {} }, { CASE("T7") {} },
+        };
+
+        std::ostringstream all;
+        EXPECT( 0 == run( spec, { "--list-tests", "T" }, all ) );
+
+        std::multiset<std::string> names;
+        for ( int i = 0; i < 3; ++i )
+        {
+            std::ostringstream os;
+            EXPECT( 0 == run( spec, { "--list-tests", "--shard-count=3", "--shard-index=" + std::to_string( i ), "T" }, os ) );
+
+            std::istringstream lines( os.str() );
+            for ( std::string name; std::getline( lines, name ); )
+                names.insert( name );
+        }
+
+        std::ostringstream first;
+        EXPECT( 0 == run( spec, { "--list-tests", "--shard-index=0", "--shard-count=3", "T" }, first ) );
+
+        EXPECT( first.str() == "T1\nT5\n" );
+        EXPECT( names == std::multiset<std::string>( { "T1", "T2", "T4", "T5", "T7" } ) );
+        EXPECT( all.str() == "T1\nT2\nT4\nT5\nT7\n" );
+
+        std::ostringstream error;
+        EXPECT( 1 == run( spec, { "--shard-index=3", "--shard-count=3" }, error ) );
+        EXPECT( std::string::npos != error.str().find( "--shard-index less than --shard-count" ) );
+    },
+
+    CASE("expression decomposition is described for failing and reported passing expectations")
+    {
+        EXPECT( lest::result( lest_DECOMPOSE_IF( 1 == 2, false, true ) ).decomposition == "1 == 2" );
+        EXPECT( lest::result( lest_DECOMPOSE_IF( 1 == 1, false, true ) ).decomposition == "" );
+        EXPECT( lest::result( lest_DECOMPOSE_IF( 1 == 1, true, false ) ).decomposition == "1 == 1" );
+
+        test pass[] = {{ CASE("P") { EXPECT( 1 < 2 ); EXPECT_NOT( 3 < 2 ); } }};
+        test fail[] = {{ CASE("F") { EXPECT_NOT( 1 < 2 ); } }};
+
+        std::ostringstream os_pass, os_zen, os_fail;
+
+        EXPECT( 0 == run( pass, { "--pass" }, os_pass ) );
+        EXPECT( 0 == run( pass, { "--pass-zen" }, os_zen ) );
+        EXPECT( 1 == run( fail, os_fail ) );
+
+        EXPECT( std::string::npos != os_pass.str().find( "1 < 2 for 1 < 2" ) );
+        EXPECT( std::string::npos != os_pass.str().find( "! ( 3 < 2 ) for ! ( 3 < 2 )" ) );
+        EXPECT( std::string::npos == os_zen.str().find( " for " ) );
+        EXPECT( std::string::npos != os_fail.str().find( "! ( 1 < 2 ) for ! ( 1 < 2 )" ) );
+    },
+
     CASE("not_equal_to matches properly")
     {
         EXPECT(  true == not_equal_to(3)(4) );
@@ -202,6 +740,116 @@ const test specification[] =
         EXPECT( false == ends_with( hello() )( hello_world() ) );
     },
 
+    CASE("ends_with matches a text that also occurs earlier")
+    {
+        EXPECT(  true == ends_with( "ab" )( "abab" ) );
+        EXPECT( false == ends_with( "abc" )( "bc" ) );
+    },
+
+    CASE("contains finds text at any position in a long string")
+    {
+        for ( std::size_t pos = 0; pos < 100; ++pos )
+        {
+            std::string text( 100, 'x' );
+            text.replace( pos, std::string::npos, "x-needle-x" );
+
+            EXPECT(  true == contains( "-needle-" )( text ) );
+            EXPECT( false == contains( "-needle+" )( text ) );
+        }
+    },
+
+    CASE("contains_any_of matches properly")
+    {
+        EXPECT(  true == contains_any_of( { "hola", "world" } )( hello_world() ) );
+        EXPECT(  true == contains_any_of( { "lo w", "o" } )( hello_world() ) );
+        EXPECT( false == contains_any_of( { "hola", "mundo" } )( hello_world() ) );
+        EXPECT( false == contains_any_of( {} )( hello_world() ) );
+
+        test fail[] = {{ CASE("F") { EXPECT_THAT( hello_world(), contains_any_of( { "hola", "mundo" } ) ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+        EXPECT( std::string::npos != os.str().find( "contains any of { \"hola\", \"mundo\", }: none found" ) );
+    },
+
+    CASE("contains_all_of matches properly")
+    {
+        EXPECT(  true == contains_all_of( { "hello", "lo wo", "world", "o" } )( hello_world() ) );
+        EXPECT(  true == contains_all_of( { "" } )( hello_world() ) );
+        EXPECT(  true == contains_all_of( {} )( hello_world() ) );
+        EXPECT( false == contains_all_of( { "hello", "mundo" } )( hello_world() ) );
+
+        test fail[] = {{ CASE("F") { EXPECT_THAT( hello_world(), contains_all_of( { "hola", "hello", "mundo" } ) ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+        EXPECT( std::string::npos != os.str().find( "missing { \"hola\", \"mundo\", }" ) );
+    },
+
+    CASE("contains_any_of, contains_all_of match many, overlapping texts properly")
+    {
+        std::vector<std::string> texts{ "he", "she", "his", "hers", "ers" };
+        for ( int i = 0; i < 40; ++i )
+            texts.push_back( "absent" + std::to_string( i ) );
+
+        const std::string actual = "ushers";
+
+        EXPECT(  true == contains_any_of( texts )( actual ) );
+        EXPECT( false == contains_all_of( texts )( actual ) );
+        EXPECT(  true == contains_all_of( { "he", "she", "hers", "ers" } )( actual ) );
+
+        texts.erase( texts.begin() + 5, texts.end() );
+        texts.erase( texts.begin() + 2 );
+        for ( int i = 0; i < 40; ++i )
+            texts.push_back( "s" );
+
+        EXPECT(  true == contains_all_of( texts )( actual ) );
+        EXPECT( false == contains_any_of( std::vector<std::string>( 40, "his" ) )( actual ) );
+    },
+
+    CASE("textual matchers accept contiguous character ranges")
+    {
+        std::string text( hello_world() );
+        std::vector<char> chars( text.begin(), text.end() );
+
+        EXPECT(  true == starts_with( hello() )( chars ) );
+        EXPECT(  true == ends_with( world() )( chars ) );
+        EXPECT(  true == contains( "o w" )( chars ) );
+        EXPECT( false == contains( "hola" )( chars ) );
+
+        EXPECT(  true == starts_with( "" )( hello_world() ) );
+        EXPECT(  true == ends_with( "" )( "" ) );
+        EXPECT(  true == contains( "" )( "" ) );
+        EXPECT( false == starts_with( hello_world() )( hello() ) );
+
+        EXPECT_THAT( hello_world(), all_of( starts_with( hello() ), contains( " " ), ends_with( world() ) ) );
+    },
+
+    CASE("logical matchers fuse textual matchers and match properly")
+    {
+        auto all = all_of( starts_with( hello() ), contains( "o w" ), contains( "" ), ends_with( world() ) );
+        auto any = any_of( starts_with( "hola" ), contains( "mundo" ), ends_with( world() ) );
+
+        EXPECT(  true == all.fused );
+        EXPECT(  true == any.fused );
+        EXPECT( false == all_of( starts_with( hello() ), is_not( contains( "x" ) ) ).fused );
+
+        EXPECT(  true == all( hello_world() ) );
+        EXPECT(  true == all( std::string( hello_world() ) ) );
+        EXPECT( false == all( "hello" ) );
+        EXPECT( false == all( "hello_world" ) );
+
+        EXPECT(  true == any( hello_world() ) );
+        EXPECT(  true == any( "mundo, hola" ) );
+        EXPECT( false == any( "hello" ) );
+        EXPECT(  true == any_of( contains( "xyz" ), contains( "ello w" ) )( std::string( 100, 'x' ) + hello_world() ) );
+        EXPECT( false == any_of( contains( "xyz" ), contains( "lo  w" ) )( std::string( 100, 'x' ) + hello_world() ) );
+
+        EXPECT( all.to_string() == "(starts with \"hello\" and contains \"o w\" and contains \"\" and ends with \"world\")" );
+    },
+
     CASE("contains matches properly")
     {
         EXPECT(  true == contains( world() )( hello_world() ) );
@@ -228,6 +876,84 @@ const test specification[] =
         EXPECT( false == matches_regexp( "hola" )( hello_world() ) );
     },
 
+    CASE("regexp matchers share the compiled expression for the same pattern and flags")
+    {
+        EXPECT( matches_regexp( "h.*d" ).regex == matches_regexp( "h.*d" ).regex );
+        EXPECT( matches_regexp( "h.*d" ).regex == contains_regexp( "h.*d" ).regex );
+        EXPECT( matches_regexp( "h.*d" ).regex != matches_regexp( "h.*d", std::regex::icase ).regex );
+
+        EXPECT( true == matches_regexp( "H.*D", std::regex::icase )( hello_world() ) );
+    },
+
+    CASE("regexp cache keeps the most recently used expressions only")
+    {
+        const auto first = matches_regexp( "first-[0-9]+" ).regex;
+
+        for ( int i = 0; i < lest_FEATURE_REGEX_CACHE_SIZE; ++i )
+            EXPECT( true == matches_regexp( "x" + std::to_string( i ) )( "x" + std::to_string( i ) ) );
+
+        EXPECT( matches_regexp( "first-[0-9]+" ).regex != first );
+        EXPECT( matches_regexp( "x1" ).regex == matches_regexp( "x1" ).regex );
+    },
+
+    CASE("regexp matchers with the linear engine match properly")
+    {
+        EXPECT(  true == matches_regexp( "h.*d", regex_engine::linear )( hello_world() ) );
+        EXPECT(  true == matches_regexp( "(?:hel+o|hola) [w-z]\\w{4}$", regex_engine::linear )( hello_world() ) );
+        EXPECT(  true == matches_regexp( "H[A-Z]+ WORLD", std::regex::icase, regex_engine::linear )( hello_world() ) );
+        EXPECT(  true == contains_regexp( "o\\sw", regex_engine::linear )( hello_world() ) );
+
+        EXPECT( false == matches_regexp( "hello", regex_engine::linear )( hello_world() ) );
+        EXPECT( false == contains_regexp( "^world", regex_engine::linear )( hello_world() ) );
+
+        EXPECT( true == matches_regexp( "h.*d", regex_engine::linear ).regex->is_linear() );
+    },
+
+    CASE("regexp matchers with the linear engine fall back to std::regex for unsupported constructs")
+    {
+        EXPECT( false == contains_regexp( "\\bworld", regex_engine::linear ).regex->is_linear() );
+
+        EXPECT(  true == contains_regexp( "\\bworld", regex_engine::linear )( hello_world() ) );
+        EXPECT( false == contains_regexp( "\\borld" , regex_engine::linear )( hello_world() ) );
+    },
+
+    CASE("regexp matchers with the linear engine leave a quantifier that follows a quantifier to std::regex")
+    {
+        EXPECT( false == is_linear( "a**"     ) );
+        EXPECT( false == is_linear( "a{2}{3}" ) );
+        EXPECT( false == is_linear( "a+?*"    ) );
+
+        EXPECT( true == matches_regexp( "(?:a{2}){3}", regex_engine::linear )( "aaaaaa" ) );
+        EXPECT(  true == is_linear( "a+?b" ) );
+    },
+
+    CASE("regexp matchers with the linear engine match concurrently with the same expression")
+    {
+        const auto match = contains_regexp( "x[0-9]+y", regex_engine::linear );
+
+        std::vector<int> found( 4 );
+        std::vector<std::thread> threads;
+
+        for ( std::size_t t = 0; t < found.size(); ++t )
+        {
+            threads.emplace_back( [&, t]
+            {
+                for ( int i = 0; i < 200; ++i )
+                    found[t] += match( "ab x" + std::to_string( i ) + ( i % 2 ? "y" : "z" ) );
+            } );
+        }
+        for ( auto & thread : threads )
+            thread.join();
+
+        EXPECT( found == std::vector<int>( 4, 100 ) );
+    },
+
+    CASE("regexp matchers with the linear engine take linear time for a pathological expression")
+    {
+        EXPECT( false == matches_regexp( "(a*)*b", regex_engine::linear )( std::string( 100000, 'a' ) ) );
+        EXPECT( false == contains_regexp( "(a|aa)*b", regex_engine::linear )( std::string( 100000, 'a' ) ) );
+    },
+
     // sequence:
 
     CASE("set of int is empty")
@@ -236,9 +962,7 @@ const test specification[] =
         EXPECT( false == is_empty()( s ) );
         
         EXPECT_THAT( u, is_empty() );
-
-// not yet:
-//        EXPECT_THAT( s, is_not( is_empty() ) );
+        EXPECT_THAT( s, is_not( is_empty() ) );
     },
 
     CASE("size of set match")
@@ -271,9 +995,30 @@ const test specification[] =
         EXPECT_THAT( s, contains( 2 ) );
         EXPECT_THAT( s, contains( 3 ) );
 
-// not yet:
-//        EXPECT_THAT( s, is_not( contains( 0 ) ) );
-//        EXPECT_THAT( s, is_not( contains( 4 ) ) );
+        EXPECT_THAT( s, is_not( contains( 0 ) ) );
+        EXPECT_THAT( s, is_not( contains( 4 ) ) );
+    },
+
+    CASE("associative, hashed and sorted containers contain element")
+    {
+        std::vector<int> v{ 1, 3, 5, 7, 9 };
+        std::unordered_map<int, std::string> m{ { 1, "one" }, { 3, "three" } };
+        std::vector<int> w{ 9, 7, 5, 3, 1 };
+
+        EXPECT(  true == contains( 3 )( std::unordered_set<int>( v.begin(), v.end() ) ) );
+        EXPECT( false == contains( 4 )( std::unordered_set<int>( v.begin(), v.end() ) ) );
+        EXPECT(  true == contains( 3 )( m ) );
+        EXPECT( false == contains( 2 )( m ) );
+
+        EXPECT(  true == contains( 9 )( sorted( v ) ) );
+        EXPECT( false == contains( 4 )( sorted( v ) ) );
+        EXPECT( false == contains( 0 )( sorted( v ) ) );
+        EXPECT( false == contains( 10 )( sorted( v ) ) );
+        EXPECT(  true == contains( 1 )( sorted( w, std::greater<int>() ) ) );
+        EXPECT( false == contains( 2 )( sorted( w, std::greater<int>() ) ) );
+
+        EXPECT_THAT( sorted( v ), contains_elements( { 1, 5, 9 } ) );
+        EXPECT_THAT( sorted( v ), is_not( contains( 2 ) ) );
     },
 
     CASE("set of int contains sequence")
@@ -296,6 +1041,37 @@ const test specification[] =
         EXPECT( 1 == run( fail, os ) );
     },
 
+    CASE("contiguous and random-access containers contain sequence")
+    {
+        std::vector<std::uint8_t> bytes;
+        std::vector<std::int16_t> samples;
+        for ( int i = 0; i < 5000; ++i )
+        {
+            bytes.push_back( static_cast<std::uint8_t>( i * i % 251 ) );
+            samples.push_back( static_cast<std::int16_t>( i * i % 4001 - 2000 ) );
+        }
+
+        std::vector<std::int16_t> pattern( samples.begin() + 4000, samples.begin() + 4300 );
+        std::deque<std::int16_t> deque( samples.begin(), samples.end() );
+
+        EXPECT(  true == contains( { 0, 1, 4, 9 } )( bytes ) );
+        EXPECT(  true == contains( std::vector<std::uint8_t>( bytes.end() - 7, bytes.end() ) )( bytes ) );
+        EXPECT(  true == contains( pattern )( samples ) );
+        EXPECT(  true == contains( pattern )( deque ) );
+        EXPECT(  true == contains( std::vector<int>( pattern.begin(), pattern.end() ) )( samples ) );
+        EXPECT(  true == contains( std::vector<int>() )( samples ) );
+
+        EXPECT( false == contains( { 0, 1, 4, 256 + 9 } )( bytes ) );
+        EXPECT( false == contains( { 0, 1, 4, -247 } )( bytes ) );
+        EXPECT( false == contains( { 0, 1, 4, 8 } )( bytes ) );
+        EXPECT( false == contains( bytes )( std::vector<std::uint8_t>( bytes.begin(), bytes.end() - 1 ) ) );
+
+        pattern.back() = 3000;
+
+        EXPECT( false == contains( pattern )( samples ) );
+        EXPECT( false == contains( pattern )( deque ) );
+    },
+
     CASE("set of int contains elements")
     {
         EXPECT(  true == contains_elements( { 3       } )( s ) );
@@ -310,20 +1086,246 @@ const test specification[] =
         EXPECT_THAT(  s, contains_elements( { 3, 2    } ) );
         EXPECT_THAT(  s, contains_elements( { 3, 2, 1 } ) );
 
-        test fail[] = {{ CASE("F") { 
+        test fail[] = {{ CASE("F") {
         EXPECT_THAT(  s, contains_elements( { 7, 2, 1 } ) ); } }};
-        
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+    },
+
+    CASE("contains elements matches many elements of large containers properly")
+    {
+        std::vector<int> ids( 100000 );
+        for ( std::size_t i = 0; i < ids.size(); ++i )
+            ids[i] = static_cast<int>( 3 * i );
+
+        std::vector<int> expected;
+        for ( int i = 0; i < 10000; ++i )
+            expected.push_back( 27 * i );
+
+        std::vector<std::pair<int,int>> pairs;
+        for ( int i = 0; i < 100; ++i )
+            pairs.push_back( std::make_pair( i, -i ) );
+
+        std::vector<std::pair<int,int>> expected_pairs( pairs.rbegin(), pairs.rbegin() + 20 );
+
+        EXPECT(  true == contains_elements( expected )( ids ) );
+        EXPECT(  true == contains_elements( expected )( std::set<int>( ids.begin(), ids.end() ) ) );
+        EXPECT(  true == contains_elements( expected_pairs )( pairs ) );
+
+        expected.push_back( 1 );
+        expected_pairs.push_back( std::make_pair( 1, 1 ) );
+
+        EXPECT( false == contains_elements( expected )( ids ) );
+        EXPECT( false == contains_elements( expected )( std::set<int>( ids.begin(), ids.end() ) ) );
+        EXPECT( false == contains_elements( expected_pairs )( pairs ) );
+
+        test fail[] = {{ CASE("F") { EXPECT_THAT( s, contains_elements( { 7, 2, 1, 9, 7 } ) ); } }};
+
         std::ostringstream os;
 
         EXPECT( 1 == run( fail, os ) );
+        EXPECT( std::string::npos != os.str().find( "missing { 7, 9, 7, }" ) );
+    },
+
+    CASE("contains in any order matches elements as a multiset")
+    {
+        std::vector<int> v{ 3, 1, 2, 1 };
+        std::deque<int> l{ 1, 1, 2, 3 };
+        std::vector<std::pair<int,int>> pairs{ { 1, 2 }, { 3, 4 } };
+        std::vector<std::set<int>> sets{ { 1 }, { 2 } };
+
+        std::vector<int> large( 100000 );
+        for ( std::size_t i = 0; i < large.size(); ++i )
+            large[i] = static_cast<int>( i % 1000 );
+        std::vector<int> shuffled( large.rbegin(), large.rend() );
+
+        EXPECT(  true == contains_in_any_order( { 1, 1, 2, 3 } )( v ) );
+        EXPECT(  true == is_permutation_of( l )( v ) );
+        EXPECT(  true == unordered_equal_to( v )( l ) );
+        EXPECT(  true == is_permutation_of( large )( shuffled ) );
+        EXPECT(  true == contains_in_any_order( { std::make_pair( 3, 4 ), std::make_pair( 1, 2 ) } )( pairs ) );
+        EXPECT(  true == contains_in_any_order( { std::set<int>{ 2 }, std::set<int>{ 1 } } )( sets ) );
+
+        EXPECT( false == contains_in_any_order( { 1, 2, 3 } )( v ) );
+        EXPECT( false == contains_in_any_order( { 1, 2, 3, 3 } )( v ) );
+        EXPECT( false == contains_in_any_order( { std::make_pair( 3, 4 ) } )( pairs ) );
+        EXPECT( false == contains_in_any_order( { std::set<int>{ 2 }, std::set<int>{ 2 } } )( sets ) );
+
+        shuffled[0] = -1;
+
+        EXPECT( false == is_permutation_of( large )( shuffled ) );
+
+        test fail[] = {{ CASE("F") { EXPECT_THAT( std::vector<int>( { 3, 1, 2, 1 } ), contains_in_any_order( { 1, 2, 3, 4, 4 } ) ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+        EXPECT( std::string::npos != os.str().find( "surplus { 1, }, missing { 4, 4, }" ) );
+
+        test fail_many[] = {{ CASE("F") { EXPECT_THAT( std::vector<int>( 30, 7 ), is_permutation_of( std::vector<int>( { 3, 1, 2, 1 } ) ) ); } }};
+
+        std::ostringstream os_many;
+
+        EXPECT( 1 == run( fail_many, os_many ) );
+        EXPECT( std::string::npos != os_many.str().find( "7, ... (20 more) }, missing { 3, 1, 2, 1, }" ) );
+    },
+
+    CASE("is sorted and is strictly increasing match properly")
+    {
+        std::vector<int> v{ 1, 2, 2, 5, 8 };
+        std::list<int> l{ 8, 5, 2, 2, 1 };
+
+        EXPECT(  true == is_sorted()( v ) );
+        EXPECT(  true == is_sorted()( std::vector<int>() ) );
+        EXPECT(  true == is_sorted( std::greater<int>() )( l ) );
+        EXPECT(  true == is_strictly_increasing()( s ) );
+
+        EXPECT( false == is_sorted()( l ) );
+        EXPECT( false == is_strictly_increasing()( v ) );
+        EXPECT( false == is_strictly_increasing( std::greater<int>() )( l ) );
+
+        test fail[] = {{ CASE("F") { EXPECT_THAT( std::vector<int>( { 1, 2, 3, 4, 5, 0, 6, 7, 8, 9 } ), is_sorted() ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+        EXPECT( std::string::npos != os.str().find( "violated at index 5: { ..., [3] 4, [4] 5, [5] 0, [6] 6, [7] 7, ... }" ) );
+    },
+
+    CASE("has unique elements matches properly")
+    {
+        std::vector<int> ids( 100000 );
+        for ( std::size_t i = 0; i < ids.size(); ++i )
+            ids[i] = static_cast<int>( 7 * i );
+
+        EXPECT(  true == has_unique_elements()( ids ) );
+        EXPECT(  true == has_unique_elements()( std::vector<std::pair<int,int>>{ { 1, 2 }, { 2, 1 } } ) );
+        EXPECT(  true == has_unique_elements()( std::vector<std::set<int>>{ { 1 }, { 2 } } ) );
+
+        ids.push_back( 700 );
+
+        EXPECT( false == has_unique_elements()( ids ) );
+        EXPECT( false == has_unique_elements()( std::vector<std::pair<int,int>>{ { 1, 2 }, { 1, 2 } } ) );
+        EXPECT( false == has_unique_elements()( std::vector<std::set<int>>{ { 1 }, { 1 } } ) );
+
+        test fail[] = {{ CASE("F") { EXPECT_THAT( std::vector<int>( { 3, 1, 3 } ), has_unique_elements() ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+        EXPECT( std::string::npos != os.str().find( "violated at index 2: { [0] 3, [1] 1, [2] 3, }" ) );
+    },
+
+    CASE("is heap and is partitioned by match properly")
+    {
+        std::vector<int> v{ 1, 4, 2, 8, 5, 7 };
+        std::vector<int> heap( v );
+        std::make_heap( heap.begin(), heap.end() );
+
+        EXPECT(  true == is_heap()( heap ) );
+        EXPECT(  true == is_heap( std::greater<int>() )( std::vector<int>{ 1, 2, 3 } ) );
+        EXPECT(  true == is_partitioned_by( less_than( 5 ) )( std::vector<int>{ 1, 4, 2, 8, 5, 7 } ) );
+        EXPECT(  true == is_partitioned_by( less_than( 5 ) )( std::list<int>{ 8, 5 } ) );
+
+        EXPECT( false == is_heap()( v ) );
+        EXPECT( false == is_partitioned_by( greater_than( 4 ) )( v ) );
+
+        EXPECT_THAT( v, is_not( is_heap() ) );
+        EXPECT_THAT( v, all_of( is_partitioned_by( less_than( 5 ) ), is_not( is_sorted() ) ) );
+
+        test fail[] = {{ CASE("F") { EXPECT_THAT( std::vector<int>( { 1, 4, 2, 8, 5, 7 } ), is_partitioned_by( is_not( 4 ) ) ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+        EXPECT( std::string::npos != os.str().find( "violated at index 2: { [0] 1, [1] 4, [2] 2, [3] 8, [4] 5, ... }" ) );
     },
 
     // dictionary:
 
-    //using lest::has_entries;
-    //using lest::has_entry;
-    //using lest::has_key;
-    //using lest::has_value;
+    CASE("has_key matches properly")
+    {
+        std::map<std::string, int> m{ { "one", 1 }, { "two", 2 } };
+        std::vector<std::pair<int, std::string>> v{ { 1, "one" }, { 2, "two" } };
+
+        EXPECT(  true == has_key( "one" )( m ) );
+        EXPECT(  true == has_key( 2 )( v ) );
+        EXPECT(  true == has_key( starts_with( "tw" ) )( m ) );
+
+        EXPECT( false == has_key( "three" )( m ) );
+        EXPECT( false == has_key( 3 )( v ) );
+        EXPECT( false == has_key( starts_with( "th" ) )( m ) );
+
+        EXPECT_THAT( m, has_key( "two" ) );
+        EXPECT_THAT( m, is_not( has_key( "zero" ) ) );
+    },
+
+    CASE("has_value matches properly")
+    {
+        std::unordered_map<int, std::string> m{ { 1, "one" }, { 2, "two" } };
+
+        EXPECT(  true == has_value( "two" )( m ) );
+        EXPECT(  true == has_value( ends_with( "ne" ) )( m ) );
+
+        EXPECT( false == has_value( "three" )( m ) );
+        EXPECT( false == has_value( ends_with( "ree" ) )( m ) );
+    },
+
+    CASE("has_entry matches properly")
+    {
+        std::multimap<int, std::string> m{ { 1, "one" }, { 2, "two" }, { 2, "zwei" } };
+
+        EXPECT(  true == has_entry( 1, "one" )( m ) );
+        EXPECT(  true == has_entry( 2, "zwei" )( m ) );
+        EXPECT(  true == has_entry( 2, starts_with( "z" ) )( m ) );
+        EXPECT(  true == has_entry( greater_than( 1 ), "two" )( m ) );
+        EXPECT(  true == has_entry( less_than( 2 ), contains( "n" ) )( m ) );
+
+        EXPECT( false == has_entry( 1, "two" )( m ) );
+        EXPECT( false == has_entry( 3, "three" )( m ) );
+        EXPECT( false == has_entry( 1, starts_with( "z" ) )( m ) );
+        EXPECT( false == has_entry( less_than( 2 ), "two" )( m ) );
+
+        EXPECT_THAT( m, has_entry( 2, "two" ) );
+    },
+
+    CASE("has_entries matches properly")
+    {
+        std::map<int, int> m;
+        std::unordered_map<int, int> u;
+        for ( int i = 0; i < 1000; ++i )
+        {
+            m[ 2 * i ] = i; u[ 2 * i ] = i;
+        }
+
+        std::map<int, int> few{ { 4, 2 }, { 0, 0 } }, many;
+        for ( int i = 0; i < 500; ++i )
+            many[ 4 * i ] = 2 * i;
+
+        EXPECT(  true == has_entries( few )( m ) );
+        EXPECT(  true == has_entries( many )( m ) );
+        EXPECT(  true == has_entries( many )( u ) );
+        EXPECT(  true == has_entries( { std::make_pair( 6, 3 ) } )( m ) );
+
+        many[ 6 ] = 4;
+        few[ 3 ] = 0;
+
+        EXPECT( false == has_entries( few )( m ) );
+        EXPECT( false == has_entries( many )( m ) );
+        EXPECT( false == has_entries( many )( u ) );
+        EXPECT( false == has_entries( { std::make_pair( 6, 4 ) } )( m ) );
+
+        std::map<std::string, std::string> d{ { "one", "1" }, { "two", "2" } };
+
+        test fail[] = {{ CASE_ON("F", &d) { EXPECT_THAT( d, has_entries( { std::make_pair( "one", "1" ), std::make_pair( "two", "3" ), std::make_pair( "zero", "0" ) } ) ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+        EXPECT( std::string::npos != os.str().find( "missing { { \"two\", \"3\" }, { \"zero\", \"0\" }, }" ) );
+    },
 
     // logical: 
 
@@ -367,6 +1369,100 @@ const test specification[] =
         EXPECT( 1 == run( fail_2, os ) );
         EXPECT( 1 == run( fail_3, os ) );
     },
+
+    CASE("logical matchers composed by value provide a type-erased copy")
+    {
+        lest::Matcher<int> m = all_of( greater_than(1), is_not( less_than(5) ), any_of( equal_to(7), equal_to(9) ) ).copy();
+
+        EXPECT(  true == (*m)( 7 ) );
+        EXPECT(  true == (*m)( 9 ) );
+        EXPECT( false == (*m)( 8 ) );
+        EXPECT( false == (*m)( 3 ) );
+
+        EXPECT( m->to_string() == "(is greater than 1 and not (is less than 5) and (is equal to 7 or is equal to 9))" );
+    },
+
+    CASE("any_matcher stores small matchers in place and copies by value")
+    {
+        any_matcher<int> small = equal_to( 3 );
+        any_matcher<int> large = all_of( equal_to( 3 ), not_equal_to( 4 ), not_equal_to( 5 ) );
+
+        EXPECT(  true == small.is_local() );
+        EXPECT( false == large.is_local() );
+
+        any_matcher<int> copy = large;
+        large = small;
+
+        EXPECT(  true == small( 3 ) );
+        EXPECT(  true == large( 3 ) );
+        EXPECT(  true == copy( 3 ) );
+        EXPECT( false == copy( 4 ) );
+
+        EXPECT( large.to_string() == "is equal to 3" );
+        EXPECT( copy.to_string() == "(is equal to 3 and is not equal to 4 and is not equal to 5)" );
+    },
+
+    CASE("any_matcher that was moved from matches nothing and can be copied, described and reassigned")
+    {
+        any_matcher<int> small = equal_to( 3 );
+        any_matcher<int> large = all_of( equal_to( 3 ), not_equal_to( 4 ), not_equal_to( 5 ) );
+
+        any_matcher<int> taken_small = std::move( small );
+        any_matcher<int> taken_large = std::move( large );
+
+        any_matcher<int> copy = small;
+
+        EXPECT( false == small( 3 ) );
+        EXPECT( false == large( 3 ) );
+        EXPECT( false == copy( 3 ) );
+        EXPECT( false == large.is_local() );
+        EXPECT( small.to_string() == "" );
+        EXPECT( false == (*copy.copy())( 3 ) );
+
+        large = taken_small;
+
+        EXPECT( true == large( 3 ) );
+        EXPECT( true == taken_large( 3 ) );
+    },
+
+    CASE("any_matcher wraps a type-erased Matcher<T>")
+    {
+        lest::Matcher<int> shared = less_than( 3 ).copy();
+        any_matcher<int> m = shared;
+
+        EXPECT(  true == m( 2 ) );
+        EXPECT( false == m( 3 ) );
+        EXPECT( m.to_string() == "is less than 3" );
+    },
+
+    CASE("logical matchers combine a runtime-built list of any_matcher")
+    {
+        std::vector<any_matcher<int>> list{ equal_to( a() ), equal_to( b() ), greater_than( c() ) };
+
+        EXPECT_THAT( a(), any_of( list ) );
+        EXPECT_THAT( 99 , any_of( list ) );
+        EXPECT_THAT( a(), is_not( all_of( list ) ) );
+
+        test fail[] = {{ CASE_ON("F", &list) { EXPECT_THAT( c(), any_of( list ) ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+        EXPECT( std::string::npos != os.str().find( "(is equal to 33 or is equal to 55 or is greater than 77)" ) );
+    },
+
+    CASE("logical matchers accept sequence matchers")
+    {
+        EXPECT_THAT( s, all_of( contains( 1 ), size_is( 3 ) ) );
+        EXPECT_THAT( s, any_of( contains( 7 ), contains( { 2, 3 } ) ) );
+        EXPECT_THAT( s, is( size_is( less_than( 4u ) ) ) );
+
+        test fail[] = {{ CASE("F") { EXPECT_THAT( s, all_of( contains( 1 ), is_empty() ) ); } }};
+
+        std::ostringstream os;
+
+        EXPECT( 1 == run( fail, os ) );
+    },
 };
 
 int main()